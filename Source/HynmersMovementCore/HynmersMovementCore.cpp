@@ -0,0 +1,400 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementCore.h"
+#include "HynmersTangentMath.h"
+
+const float FHynmersOrientationSolver::SurfaceChangeCos = 0.7071f;
+
+void FHynmersOrientationSolver::AddFloorNormal(const FVector& Normal)
+{
+	if (NumFloorNormals > 0 && (FloorNormals[NewestIndex] | Normal) < SurfaceChangeCos)
+	{
+		NumFloorNormals = 0;
+	}
+
+	NewestIndex = (NewestIndex + 1) % MaxFloorNormals;
+	FloorNormals[NewestIndex] = Normal;
+	NumFloorNormals = FMath::Min(NumFloorNormals + 1, (int32)MaxFloorNormals);
+}
+
+FVector FHynmersOrientationSolver::GetBlendedFloorNormal(const FVector& Fallback) const
+{
+	FVector Sum = FVector::ZeroVector;
+	for (int32 Age = 0; Age < NumFloorNormals; ++Age)
+	{
+		const int32 Index = (NewestIndex - Age + MaxFloorNormals) % MaxFloorNormals;
+		Sum += FloorNormals[Index] * (float)(MaxFloorNormals - Age);
+	}
+	return Sum.GetSafeNormal(SMALL_NUMBER, Fallback);
+}
+
+FQuat FHynmersOrientationSolver::ComputeDeltaRotation(const FVector& CurrentUp, const FVector& TargetUp, float MaxAngle)
+{
+	const FQuat FullRotation = FQuat::FindBetweenNormals(CurrentUp, TargetUp);
+
+	FVector Axis;
+	float Angle;
+	FullRotation.ToAxisAndAngle(Axis, Angle);
+	if (Angle <= MaxAngle)
+	{
+		return FullRotation;
+	}
+	return FQuat(Axis, MaxAngle);
+}
+
+namespace HynmersMovementCore
+{
+	FVector ComputeSlideVector(const FHynmersMovementFrame& Frame, const FVector& Delta, float Time, const FVector& Normal)
+	{
+		if (!Frame.bConstrainToPlane)
+		{
+			return HynmersTangentMath::ProjectOnPlane(Delta, Normal) * Time;
+		}
+
+		const FVector ProjectedNormal = HynmersTangentMath::ProjectOnPlaneSafeNormal(Normal, Frame.PlaneConstraintNormal);
+		return HynmersTangentMath::ProjectOnPlane(Delta, ProjectedNormal) * Time;
+	}
+
+	bool IsWalkableNormal(const FVector& ImpactNormal, const FVector& Up, float WalkableFloorZ)
+	{
+		const float NormalDotUp = ImpactNormal | Up;
+
+		// Never walk up vertical surfaces
+		return NormalDotUp >= KINDA_SMALL_NUMBER && NormalDotUp >= WalkableFloorZ;
+	}
+
+	FVector ComputeGroundMovementDelta(const FHynmersMovementFrame& Frame, const FVector& Delta, const FVector& FloorNormal, const FVector& ContactNormal, bool bWalkableRamp, bool bMaintainHorizontalGroundVelocity)
+	{
+		const float FloorDotUp = FloorNormal | Frame.Up;
+		if (FloorDotUp < (1.f - KINDA_SMALL_NUMBER) && FloorDotUp > KINDA_SMALL_NUMBER && (ContactNormal | Frame.Up) > KINDA_SMALL_NUMBER && bWalkableRamp)
+		{
+			// Compute a vector that moves parallel to the surface, by projecting the horizontal movement direction onto the ramp.
+			const float FloorDotDelta = (FloorNormal | Delta);
+			const FVector RampMovement = HynmersTangentMath::ProjectOnAxes(Delta, Frame.Right, Frame.Forward, Frame.Up, -FloorDotDelta / FloorDotUp);
+
+			if (bMaintainHorizontalGroundVelocity)
+			{
+				return RampMovement;
+			}
+			return RampMovement.GetSafeNormal() * Delta.Size();
+		}
+
+		return Delta;
+	}
+
+	FVector HandleSlopeBoosting(const FHynmersMovementFrame& Frame, const FVector& SlideResult, const FVector& Delta, float Time, const FVector& Normal)
+	{
+		FVector Result = SlideResult;
+
+		const float ResultDotUp = Result | Frame.Up;
+		if (ResultDotUp > 0.f)
+		{
+			// Don't move any higher than we originally intended.
+			const float ZLimit = (Delta | Frame.Up) * Time;
+			if (ResultDotUp - ZLimit > KINDA_SMALL_NUMBER)
+			{
+				if (ZLimit > 0.f)
+				{
+					// Rescale the entire vector (not just the Z component) otherwise we change the direction and likely head right back into the impact.
+					Result *= ZLimit / ResultDotUp;
+				}
+				else
+				{
+					// We were heading down but were going to deflect upwards. Just make the deflection horizontal.
+					Result = FVector::ZeroVector;
+				}
+
+				// Make remaining portion of original result horizontal and parallel to impact normal.
+				const FVector RemainderXY = HynmersTangentMath::ProjectOnAxes(SlideResult - Result, Frame.Forward, Frame.Right);
+				const FVector NormalXY = HynmersTangentMath::ProjectOnPlaneSafeNormal(Normal, Frame.Up);
+				Result += ComputeSlideVector(Frame, RemainderXY, 1.f, NormalXY);
+			}
+		}
+
+		return Result;
+	}
+
+	void TwoWallAdjust(const FHynmersMovementFrame& Frame, FVector& Delta, float HitTime, const FVector& HitNormal, const FVector& OldHitNormal, bool bMovingOnGround, bool bHitWalkable, bool bFloorTooClose)
+	{
+		const FVector InDelta = Delta;
+
+		if ((OldHitNormal | HitNormal) <= 0.f) //90 or less corner, so use cross product for direction
+		{
+			const FVector DesiredDir = Delta;
+			const FVector NewDir = (HitNormal ^ OldHitNormal).GetSafeNormal();
+			Delta = (Delta | NewDir) * (1.f - HitTime) * NewDir;
+			if ((DesiredDir | Delta) < 0.f)
+			{
+				Delta = -1.f * Delta;
+			}
+		}
+		else //adjust to new wall
+		{
+			const FVector DesiredDir = Delta;
+			Delta = ComputeSlideVector(Frame, Delta, 1.f - HitTime, HitNormal);
+			if ((Delta | DesiredDir) <= 0.f)
+			{
+				Delta = FVector::ZeroVector;
+			}
+			else if (FMath::Abs((HitNormal | OldHitNormal) - 1.f) < KINDA_SMALL_NUMBER)
+			{
+				// we hit the same wall again even after adjusting to move along it the first time
+				// nudge away from it (this can happen due to precision issues)
+				Delta += HitNormal * 0.01f;
+			}
+		}
+
+		if (bMovingOnGround)
+		{
+			const float HitNormalDotUp = HitNormal | Frame.Up;
+
+			// Allow slides up walkable surfaces, but not unwalkable ones (treat those as vertical barriers).
+			if ((Delta | Frame.Up) > 0.f)
+			{
+				if (bHitWalkable && HitNormalDotUp > KINDA_SMALL_NUMBER)
+				{
+					// Maintain horizontal velocity
+					const float Time = (1.f - HitTime);
+					const FVector ScaledDelta = Delta.GetSafeNormal() * InDelta.Size();
+					Delta = HynmersTangentMath::ProjectOnAxes(InDelta, Frame.Forward, Frame.Right, Frame.Up, (ScaledDelta | Frame.Up) / HitNormalDotUp)*Time;
+				}
+				else
+				{
+					Delta = HynmersTangentMath::ProjectOnPlane(Delta, Frame.Up);
+				}
+			}
+			else if ((Delta | Frame.Up) < 0.f)
+			{
+				// Don't push down into the floor.
+				if (bFloorTooClose)
+				{
+					Delta = HynmersTangentMath::ProjectOnPlane(Delta, Frame.Up);
+				}
+			}
+		}
+	}
+
+	bool IsWithinEdgeTolerance(const FVector& Up, const FVector& CapsuleLocation, const FVector& TestImpactPoint, float CapsuleRadius)
+	{
+		const float DistFromCenterSq = HynmersTangentMath::ProjectOnPlane(TestImpactPoint - CapsuleLocation, Up).SizeSquared();
+		const float ReducedRadiusSq = FMath::Square(FMath::Max(EdgeRejectDistance + KINDA_SMALL_NUMBER, CapsuleRadius - EdgeRejectDistance));
+		return DistFromCenterSq < ReducedRadiusSq;
+	}
+
+	FVector LimitAirControl(const FHynmersMovementFrame& Frame, const FVector& FallAcceleration, const FVector& HitNormal, bool bWallHit, bool bLimitIntoWall, bool bStartPenetrating)
+	{
+		if (bWallHit)
+		{
+			// If acceleration is into the wall, limit contribution.
+			if (bLimitIntoWall && (FallAcceleration | HitNormal) < 0.f)
+			{
+				// Allow movement parallel to the wall, but not into it because that may push us up.
+				const FVector Normal2D = HynmersTangentMath::ProjectOnPlaneSafeNormal(HitNormal, Frame.Up);
+				return HynmersTangentMath::ProjectOnPlane(FallAcceleration, Normal2D);
+			}
+		}
+		else if (bStartPenetrating)
+		{
+			// Allow movement out of penetration.
+			return (FallAcceleration | HitNormal) > 0.f ? FallAcceleration : FVector::ZeroVector;
+		}
+
+		return FallAcceleration;
+	}
+
+	static const float AvoidanceEpsilon = 1.e-5f;
+
+	// Optimal point on line LineIndex within the disc of Radius and the previous lines
+	static bool SolveAvoidanceOnLine(const FHynmersAvoidanceLine* Lines, int32 LineIndex, float Radius, const FVector2D& OptVelocity, bool bDirectionOpt, FVector2D& Result)
+	{
+		const FHynmersAvoidanceLine& Line = Lines[LineIndex];
+		const float DotProduct = Line.Point | Line.Direction;
+		const float Discriminant = FMath::Square(DotProduct) + FMath::Square(Radius) - Line.Point.SizeSquared();
+		if (Discriminant < 0.f)
+		{
+			// The disc of max speed is fully outside the half plane
+			return false;
+		}
+
+		const float SqrtDiscriminant = FMath::Sqrt(Discriminant);
+		float TLeft = -DotProduct - SqrtDiscriminant;
+		float TRight = -DotProduct + SqrtDiscriminant;
+
+		for (int32 i = 0; i < LineIndex; ++i)
+		{
+			const float Denominator = Line.Direction ^ Lines[i].Direction;
+			const float Numerator = Lines[i].Direction ^ (Line.Point - Lines[i].Point);
+			if (FMath::Abs(Denominator) <= AvoidanceEpsilon)
+			{
+				// Parallel lines
+				if (Numerator < 0.f)
+				{
+					return false;
+				}
+				continue;
+			}
+
+			const float T = Numerator / Denominator;
+			if (Denominator >= 0.f)
+			{
+				TRight = FMath::Min(TRight, T);
+			}
+			else
+			{
+				TLeft = FMath::Max(TLeft, T);
+			}
+
+			if (TLeft > TRight)
+			{
+				return false;
+			}
+		}
+
+		if (bDirectionOpt)
+		{
+			Result = Line.Point + Line.Direction * ((OptVelocity | Line.Direction) > 0.f ? TRight : TLeft);
+		}
+		else
+		{
+			const float T = Line.Direction | (OptVelocity - Line.Point);
+			Result = Line.Point + Line.Direction * FMath::Clamp(T, TLeft, TRight);
+		}
+		return true;
+	}
+
+	// Returns NumLines on success, or the index of the first line that could not be satisfied
+	static int32 SolveAvoidanceLines(const FHynmersAvoidanceLine* Lines, int32 NumLines, float Radius, const FVector2D& OptVelocity, bool bDirectionOpt, FVector2D& Result)
+	{
+		if (bDirectionOpt)
+		{
+			Result = OptVelocity * Radius;
+		}
+		else if (OptVelocity.SizeSquared() > FMath::Square(Radius))
+		{
+			Result = OptVelocity.GetSafeNormal() * Radius;
+		}
+		else
+		{
+			Result = OptVelocity;
+		}
+
+		for (int32 i = 0; i < NumLines; ++i)
+		{
+			if ((Lines[i].Direction ^ (Lines[i].Point - Result)) > 0.f)
+			{
+				const FVector2D PreviousResult = Result;
+				if (!SolveAvoidanceOnLine(Lines, i, Radius, OptVelocity, bDirectionOpt, Result))
+				{
+					Result = PreviousResult;
+					return i;
+				}
+			}
+		}
+		return NumLines;
+	}
+
+	FHynmersAvoidanceLine ComputeAvoidanceLine(const FVector2D& Velocity, const FVector2D& RelativePosition, const FVector2D& RelativeVelocity,
+		float CombinedRadius, float TimeHorizon, float DeltaTime, float Responsibility)
+	{
+		FHynmersAvoidanceLine Line;
+		FVector2D U;
+
+		const float DistSq = RelativePosition.SizeSquared();
+		const float CombinedRadiusSq = FMath::Square(CombinedRadius);
+		if (DistSq > CombinedRadiusSq)
+		{
+			const float InvTimeHorizon = 1.f / TimeHorizon;
+			// Velocity from the center of the cut-off circle
+			const FVector2D W = RelativeVelocity - RelativePosition * InvTimeHorizon;
+			const float WLengthSq = W.SizeSquared();
+			const float DotProduct = W | RelativePosition;
+
+			if (DotProduct < 0.f && FMath::Square(DotProduct) > CombinedRadiusSq * WLengthSq)
+			{
+				// Closest to the cut-off circle
+				const float WLength = FMath::Sqrt(WLengthSq);
+				const FVector2D UnitW = W / WLength;
+				Line.Direction = FVector2D(UnitW.Y, -UnitW.X);
+				U = UnitW * (CombinedRadius * InvTimeHorizon - WLength);
+			}
+			else
+			{
+				// Closest to one of the legs of the cone
+				const float Leg = FMath::Sqrt(DistSq - CombinedRadiusSq);
+				if ((RelativePosition ^ W) > 0.f)
+				{
+					Line.Direction = FVector2D(RelativePosition.X * Leg - RelativePosition.Y * CombinedRadius, RelativePosition.X * CombinedRadius + RelativePosition.Y * Leg) / DistSq;
+				}
+				else
+				{
+					Line.Direction = -FVector2D(RelativePosition.X * Leg + RelativePosition.Y * CombinedRadius, -RelativePosition.X * CombinedRadius + RelativePosition.Y * Leg) / DistSq;
+				}
+				U = Line.Direction * (RelativeVelocity | Line.Direction) - RelativeVelocity;
+			}
+		}
+		else
+		{
+			// Already overlapping, get apart within this step
+			const float InvDeltaTime = 1.f / FMath::Max(DeltaTime, AvoidanceEpsilon);
+			const FVector2D W = RelativeVelocity - RelativePosition * InvDeltaTime;
+			const float WLength = W.Size();
+			const FVector2D UnitW = WLength > AvoidanceEpsilon ? W / WLength : FVector2D(1.f, 0.f);
+			Line.Direction = FVector2D(UnitW.Y, -UnitW.X);
+			U = UnitW * (CombinedRadius * InvDeltaTime - WLength);
+		}
+
+		Line.Point = Velocity + U * Responsibility;
+		return Line;
+	}
+
+	FVector2D SolveAvoidance(const FHynmersAvoidanceLine* Lines, int32 NumLines, const FVector2D& PreferredVelocity, float MaxSpeed)
+	{
+		FVector2D Result;
+		const int32 FailedLine = SolveAvoidanceLines(Lines, NumLines, MaxSpeed, PreferredVelocity, false, Result);
+		if (FailedLine == NumLines)
+		{
+			return Result;
+		}
+
+		// Infeasible, minimize the largest penetration into the half planes from the first failing one
+		float Distance = 0.f;
+		for (int32 i = FailedLine; i < NumLines; ++i)
+		{
+			if ((Lines[i].Direction ^ (Lines[i].Point - Result)) <= Distance)
+			{
+				continue;
+			}
+
+			TArray<FHynmersAvoidanceLine, TInlineAllocator<16>> ProjectedLines;
+			for (int32 j = 0; j < i; ++j)
+			{
+				FHynmersAvoidanceLine ProjectedLine;
+				const float Determinant = Lines[i].Direction ^ Lines[j].Direction;
+				if (FMath::Abs(Determinant) <= AvoidanceEpsilon)
+				{
+					if ((Lines[i].Direction | Lines[j].Direction) > 0.f)
+					{
+						// Same direction
+						continue;
+					}
+					ProjectedLine.Point = (Lines[i].Point + Lines[j].Point) * 0.5f;
+				}
+				else
+				{
+					ProjectedLine.Point = Lines[i].Point + Lines[i].Direction * ((Lines[j].Direction ^ (Lines[i].Point - Lines[j].Point)) / Determinant);
+				}
+				ProjectedLine.Direction = (Lines[j].Direction - Lines[i].Direction).GetSafeNormal();
+				ProjectedLines.Add(ProjectedLine);
+			}
+
+			const FVector2D PreviousResult = Result;
+			if (SolveAvoidanceLines(ProjectedLines.GetData(), ProjectedLines.Num(), MaxSpeed, FVector2D(-Lines[i].Direction.Y, Lines[i].Direction.X), true, Result) < ProjectedLines.Num())
+			{
+				// Can only fail from rounding, the previous result is the best known
+				Result = PreviousResult;
+			}
+			Distance = Lines[i].Direction ^ (Lines[i].Point - Result);
+		}
+		return Result;
+	}
+}
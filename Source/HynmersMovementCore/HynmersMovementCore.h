@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Tangent frame of a character, with the plane constraint of its movement component
+struct FHynmersMovementFrame
+{
+	FVector Up = FVector::UpVector;
+	FVector Forward = FVector::ForwardVector;
+	FVector Right = FVector::RightVector;
+	bool bConstrainToPlane = false;
+	FVector PlaneConstraintNormal = FVector::ZeroVector;
+};
+
+/*
+ * Realigns a character up vector toward its target with quaternions only.
+ * Floor targets are blended over the last floor normals so faceted and curved surfaces don't make the character jitter.
+ */
+struct HYNMERSMOVEMENTCORE_API FHynmersOrientationSolver
+{
+	enum { MaxFloorNormals = 4 };
+
+	// Normals further apart than this from the newest one are a new surface, the history restarts from it
+	static const float SurfaceChangeCos;
+
+	void AddFloorNormal(const FVector& Normal);
+
+	void Reset() { NumFloorNormals = 0; }
+
+	// Newest normals weigh the most, Fallback without history
+	FVector GetBlendedFloorNormal(const FVector& Fallback) const;
+
+	// Rotation taking CurrentUp toward TargetUp by at most MaxAngle radians
+	static FQuat ComputeDeltaRotation(const FVector& CurrentUp, const FVector& TargetUp, float MaxAngle);
+
+private:
+	FVector FloorNormals[MaxFloorNormals];
+
+	int32 NumFloorNormals = 0;
+
+	int32 NewestIndex = 0;
+};
+
+// Half plane of the velocities avoiding one neighbour in a tangent plane, the allowed side is left of Direction through Point
+struct FHynmersAvoidanceLine
+{
+	FVector2D Point;
+	FVector2D Direction;
+};
+
+/*
+ * Geometric helpers of UHynmersMovementComponent as pure functions of vectors, without UObjects or scene queries.
+ * Everything that needs the world (hit components, landing spot checks) is resolved by the caller and passed as flags.
+ */
+namespace HynmersMovementCore
+{
+	// Same as UCharacterMovementComponent::SWEEP_EDGE_REJECT_DISTANCE
+	static const float EdgeRejectDistance = 0.15f;
+
+	// Same as UCharacterMovementComponent::VERTICAL_SLOPE_NORMAL_Z
+	static const float VerticalSlopeNormalZ = 0.001f;
+
+	HYNMERSMOVEMENTCORE_API FVector ComputeSlideVector(const FHynmersMovementFrame& Frame, const FVector& Delta, float Time, const FVector& Normal);
+
+	HYNMERSMOVEMENTCORE_API bool IsWalkableNormal(const FVector& ImpactNormal, const FVector& Up, float WalkableFloorZ);
+
+	// bWalkableRamp: the ramp hit comes from a sweep and is walkable
+	HYNMERSMOVEMENTCORE_API FVector ComputeGroundMovementDelta(const FHynmersMovementFrame& Frame, const FVector& Delta, const FVector& FloorNormal, const FVector& ContactNormal, bool bWalkableRamp, bool bMaintainHorizontalGroundVelocity);
+
+	HYNMERSMOVEMENTCORE_API FVector HandleSlopeBoosting(const FHynmersMovementFrame& Frame, const FVector& SlideResult, const FVector& Delta, float Time, const FVector& Normal);
+
+	// bHitWalkable: the hit normal is walkable for the character, bFloorTooClose: a blocking floor is closer than MIN_FLOOR_DIST
+	HYNMERSMOVEMENTCORE_API void TwoWallAdjust(const FHynmersMovementFrame& Frame, FVector& Delta, float HitTime, const FVector& HitNormal, const FVector& OldHitNormal, bool bMovingOnGround, bool bHitWalkable, bool bFloorTooClose);
+
+	HYNMERSMOVEMENTCORE_API bool IsWithinEdgeTolerance(const FVector& Up, const FVector& CapsuleLocation, const FVector& TestImpactPoint, float CapsuleRadius);
+
+	// Reciprocal velocity obstacle of a neighbour (ORCA). Positions and velocities are in the tangent plane of the agent, RelativeVelocity is own minus other.
+	// Responsibility is the share of the avoidance the agent takes, 0.5 when both avoid each other.
+	HYNMERSMOVEMENTCORE_API FHynmersAvoidanceLine ComputeAvoidanceLine(const FVector2D& Velocity, const FVector2D& RelativePosition, const FVector2D& RelativeVelocity,
+		float CombinedRadius, float TimeHorizon, float DeltaTime, float Responsibility);
+
+	// Velocity closest to PreferredVelocity within MaxSpeed and all the half planes, or the one violating them the least when they conflict
+	HYNMERSMOVEMENTCORE_API FVector2D SolveAvoidance(const FHynmersAvoidanceLine* Lines, int32 NumLines, const FVector2D& PreferredVelocity, float MaxSpeed);
+
+	// bWallHit: valid blocking hit that is not a ceiling, bLimitIntoWall: the hit is not a valid landing spot
+	HYNMERSMOVEMENTCORE_API FVector LimitAirControl(const FHynmersMovementFrame& Frame, const FVector& FallAcceleration, const FVector& HitNormal, bool bWallHit, bool bLimitIntoWall, bool bStartPenetrating);
+}
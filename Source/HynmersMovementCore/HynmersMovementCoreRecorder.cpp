@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementCoreRecorder.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace HynmersCoreRecorder
+{
+	static const uint32 FileMagic = 0x43434D48; // HMCC
+	static const uint32 FileVersion = 1;
+
+	static FCriticalSection Lock;
+	static TArray<FHynmersCoreCall> Calls;
+	static int32 MaxCalls = 0;
+}
+
+volatile bool FHynmersCoreRecorder::bRecording = false;
+
+void FHynmersCoreRecorder::Start(int32 MaxCalls)
+{
+	FScopeLock ScopeLock(&HynmersCoreRecorder::Lock);
+	HynmersCoreRecorder::Calls.Reset();
+	HynmersCoreRecorder::MaxCalls = FMath::Max(MaxCalls, 1);
+	bRecording = true;
+}
+
+bool FHynmersCoreRecorder::Stop(const FString& Filename, int32& OutNumCalls)
+{
+	TArray<FHynmersCoreCall> Calls;
+	{
+		FScopeLock ScopeLock(&HynmersCoreRecorder::Lock);
+		bRecording = false;
+		Swap(Calls, HynmersCoreRecorder::Calls);
+	}
+
+	OutNumCalls = Calls.Num();
+	if (Calls.Num() == 0)
+	{
+		return false;
+	}
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	uint32 Magic = HynmersCoreRecorder::FileMagic;
+	uint32 Version = HynmersCoreRecorder::FileVersion;
+	Writer << Magic << Version << Calls;
+
+	return FFileHelper::SaveArrayToFile(Data, *Filename);
+}
+
+void FHynmersCoreRecorder::Record(const FHynmersCoreCall& Call)
+{
+	FScopeLock ScopeLock(&HynmersCoreRecorder::Lock);
+	if (bRecording && HynmersCoreRecorder::Calls.Num() < HynmersCoreRecorder::MaxCalls)
+	{
+		HynmersCoreRecorder::Calls.Add(Call);
+	}
+}
+
+bool FHynmersCoreRecorder::LoadFromFile(const FString& Filename, TArray<FHynmersCoreCall>& OutCalls)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Reader << Magic << Version;
+	if (Magic != HynmersCoreRecorder::FileMagic || Version != HynmersCoreRecorder::FileVersion)
+	{
+		return false;
+	}
+	Reader << OutCalls;
+
+	// Unknown kernels would replay as nothing
+	OutCalls.RemoveAll([](const FHynmersCoreCall& Call) { return Call.Kernel >= (uint8)EHynmersCoreKernel::Num; });
+	return !Reader.IsError();
+}
+
+float FHynmersCoreRecorder::Replay(const FHynmersCoreCall& Call)
+{
+	switch ((EHynmersCoreKernel)Call.Kernel)
+	{
+	case EHynmersCoreKernel::ComputeGroundMovementDelta:
+		return HynmersMovementCore::ComputeGroundMovementDelta(Call.Frame, Call.A, Call.B, Call.C, Call.GetFlag(0), Call.GetFlag(1)).X;
+
+	case EHynmersCoreKernel::HandleSlopeBoosting:
+		return HynmersMovementCore::HandleSlopeBoosting(Call.Frame, Call.A, Call.B, Call.Scalar, Call.C).X;
+
+	case EHynmersCoreKernel::TwoWallAdjust:
+	{
+		FVector Delta = Call.A;
+		HynmersMovementCore::TwoWallAdjust(Call.Frame, Delta, Call.Scalar, Call.B, Call.C, Call.GetFlag(0), Call.GetFlag(1), Call.GetFlag(2));
+		return Delta.X;
+	}
+
+	case EHynmersCoreKernel::IsWithinEdgeTolerance:
+		return HynmersMovementCore::IsWithinEdgeTolerance(Call.Frame.Up, Call.A, Call.B, Call.Scalar) ? 1.f : 0.f;
+
+	case EHynmersCoreKernel::LimitAirControl:
+		return HynmersMovementCore::LimitAirControl(Call.Frame, Call.A, Call.B, Call.GetFlag(0), Call.GetFlag(1), Call.GetFlag(2)).X;
+
+	case EHynmersCoreKernel::IsWalkableNormal:
+		return HynmersMovementCore::IsWalkableNormal(Call.A, Call.B, Call.Scalar) ? 1.f : 0.f;
+
+	default:
+		return 0.f;
+	}
+}
+
+const TCHAR* FHynmersCoreRecorder::GetKernelName(uint8 Kernel)
+{
+	static const TCHAR* Names[] =
+	{
+		TEXT("ComputeGroundMovementDelta"),
+		TEXT("HandleSlopeBoosting"),
+		TEXT("TwoWallAdjust"),
+		TEXT("IsWithinEdgeTolerance"),
+		TEXT("LimitAirControl"),
+		TEXT("IsWalkableNormal"),
+	};
+	static_assert(ARRAY_COUNT(Names) == (int32)EHynmersCoreKernel::Num, "Kernel names out of date");
+
+	return Kernel < ARRAY_COUNT(Names) ? Names[Kernel] : TEXT("Unknown");
+}
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HynmersMovementCore.h"
+
+enum class EHynmersCoreKernel : uint8
+{
+	ComputeGroundMovementDelta,
+	HandleSlopeBoosting,
+	TwoWallAdjust,
+	IsWithinEdgeTolerance,
+	LimitAirControl,
+	IsWalkableNormal,
+	Num
+};
+
+/*
+ * Arguments of one HynmersMovementCore call made by a running character.
+ * Vectors are stored in the order of the kernel parameters, bools in Flags from bit 0, the float parameter in Scalar.
+ * IsWalkableNormal keeps the up vector in B, it takes no frame.
+ */
+struct FHynmersCoreCall
+{
+	uint8 Kernel = 0;
+	uint8 Flags = 0;
+	FHynmersMovementFrame Frame;
+	FVector A = FVector::ZeroVector;
+	FVector B = FVector::ZeroVector;
+	FVector C = FVector::ZeroVector;
+	float Scalar = 0.f;
+
+	FHynmersCoreCall() {}
+
+	FHynmersCoreCall(EHynmersCoreKernel InKernel, const FHynmersMovementFrame& InFrame, const FVector& InA, const FVector& InB, const FVector& InC, float InScalar,
+		bool bFlag0 = false, bool bFlag1 = false, bool bFlag2 = false)
+		: Kernel((uint8)InKernel)
+		, Flags((bFlag0 ? 1 : 0) | (bFlag1 ? 2 : 0) | (bFlag2 ? 4 : 0))
+		, Frame(InFrame)
+		, A(InA)
+		, B(InB)
+		, C(InC)
+		, Scalar(InScalar)
+	{
+	}
+
+	bool GetFlag(int32 Bit) const { return (Flags & (1 << Bit)) != 0; }
+
+	friend FArchive& operator<<(FArchive& Ar, FHynmersCoreCall& Call)
+	{
+		Ar << Call.Kernel << Call.Flags << Call.Frame.Up << Call.Frame.Forward << Call.Frame.Right << Call.Frame.bConstrainToPlane << Call.Frame.PlaneConstraintNormal;
+		Ar << Call.A << Call.B << Call.C << Call.Scalar;
+		return Ar;
+	}
+};
+
+/*
+ * Records the kernel calls of the running game, so the standalone benchmark can time them on real inputs.
+ * Callers check IsRecording first, recording takes a lock and is only meant for capture sessions.
+ */
+class HYNMERSMOVEMENTCORE_API FHynmersCoreRecorder
+{
+public:
+	static bool IsRecording() { return bRecording; }
+
+	// Drops what was recorded before. Calls past MaxCalls are ignored.
+	static void Start(int32 MaxCalls);
+
+	// Writes the calls recorded since Start, false if nothing was recorded or the file could not be written
+	static bool Stop(const FString& Filename, int32& OutNumCalls);
+
+	static void Record(const FHynmersCoreCall& Call);
+
+	static bool LoadFromFile(const FString& Filename, TArray<FHynmersCoreCall>& OutCalls);
+
+	// Calls the recorded kernel with the recorded arguments, returns a value of the result
+	static float Replay(const FHynmersCoreCall& Call);
+
+	static const TCHAR* GetKernelName(uint8 Kernel);
+
+private:
+	static volatile bool bRecording;
+};
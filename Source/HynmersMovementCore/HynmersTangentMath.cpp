@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersTangentMath.h"
+
+namespace HynmersTangentMath
+{
+	// Four packed FVectors, 12 floats in 3 registers, to one register per component
+	FORCEINLINE void LoadTransposed(const FVector* Vectors, VectorRegister& OutX, VectorRegister& OutY, VectorRegister& OutZ)
+	{
+		const float* Floats = &Vectors->X;
+		const VectorRegister A = VectorLoad(Floats);		// x0 y0 z0 x1
+		const VectorRegister B = VectorLoad(Floats + 4);	// y1 z1 x2 y2
+		const VectorRegister C = VectorLoad(Floats + 8);	// z2 x3 y3 z3
+
+		const VectorRegister X2Y2X3Y3 = VectorShuffle(B, C, 2, 3, 1, 2);
+		const VectorRegister Y0Z0Y1Z1 = VectorShuffle(A, B, 1, 2, 0, 1);
+		OutX = VectorShuffle(A, X2Y2X3Y3, 0, 3, 0, 2);
+		OutY = VectorShuffle(Y0Z0Y1Z1, X2Y2X3Y3, 0, 2, 1, 3);
+		OutZ = VectorShuffle(Y0Z0Y1Z1, C, 1, 3, 0, 3);
+	}
+
+	FORCEINLINE void StoreTransposed(const VectorRegister& X, const VectorRegister& Y, const VectorRegister& Z, FVector* Vectors)
+	{
+		const VectorRegister X0X2Y0Y2 = VectorShuffle(X, Y, 0, 2, 0, 2);
+		const VectorRegister Z0Z2X1X3 = VectorShuffle(Z, X, 0, 2, 1, 3);
+		const VectorRegister Y1Y3Z1Z3 = VectorShuffle(Y, Z, 1, 3, 1, 3);
+
+		float* Floats = &Vectors->X;
+		VectorStore(VectorShuffle(X0X2Y0Y2, Z0Z2X1X3, 0, 2, 0, 2), Floats);
+		VectorStore(VectorShuffle(Y1Y3Z1Z3, X0X2Y0Y2, 0, 2, 1, 3), Floats + 4);
+		VectorStore(VectorShuffle(Z0Z2X1X3, Y1Y3Z1Z3, 1, 3, 1, 3), Floats + 8);
+	}
+
+	// All bits set in the lanes whose mask entry is set
+	FORCEINLINE VectorRegister LoadLaneMask(const uint8* Mask)
+	{
+		return VectorCompareNE(VectorLoadByte4(Mask), GlobalVectorConstants::FloatZero);
+	}
+
+	void ProjectOnPlaneBatch(FVector* Vectors, const FVector* Normals, const uint8* Mask, int32 Num)
+	{
+		int32 i = 0;
+		for (; i + 4 <= Num; i += 4)
+		{
+			VectorRegister X, Y, Z, NX, NY, NZ;
+			LoadTransposed(Vectors + i, X, Y, Z);
+			LoadTransposed(Normals + i, NX, NY, NZ);
+
+			const VectorRegister Dot = VectorMultiplyAdd(Z, NZ, VectorMultiplyAdd(Y, NY, VectorMultiply(X, NX)));
+			const VectorRegister LaneMask = LoadLaneMask(Mask + i);
+			X = VectorSelect(LaneMask, VectorSubtract(X, VectorMultiply(Dot, NX)), X);
+			Y = VectorSelect(LaneMask, VectorSubtract(Y, VectorMultiply(Dot, NY)), Y);
+			Z = VectorSelect(LaneMask, VectorSubtract(Z, VectorMultiply(Dot, NZ)), Z);
+			StoreTransposed(X, Y, Z, Vectors + i);
+		}
+
+		for (; i < Num; ++i)
+		{
+			if (Mask[i])
+			{
+				const VectorRegister Result = ProjectOnPlane(VectorLoadFloat3_W0(&Vectors[i]), VectorLoadFloat3_W0(&Normals[i]));
+				VectorStoreFloat3(Result, &Vectors[i]);
+			}
+		}
+	}
+
+	void ProjectOnAxesBatch(FVector* Vectors, const FVector* AxesX, const FVector* AxesY, const uint8* Mask, int32 Num)
+	{
+		int32 i = 0;
+		for (; i + 4 <= Num; i += 4)
+		{
+			VectorRegister X, Y, Z, AXX, AXY, AXZ, AYX, AYY, AYZ;
+			LoadTransposed(Vectors + i, X, Y, Z);
+			LoadTransposed(AxesX + i, AXX, AXY, AXZ);
+			LoadTransposed(AxesY + i, AYX, AYY, AYZ);
+
+			const VectorRegister DotX = VectorMultiplyAdd(Z, AXZ, VectorMultiplyAdd(Y, AXY, VectorMultiply(X, AXX)));
+			const VectorRegister DotY = VectorMultiplyAdd(Z, AYZ, VectorMultiplyAdd(Y, AYY, VectorMultiply(X, AYX)));
+			const VectorRegister LaneMask = LoadLaneMask(Mask + i);
+			X = VectorSelect(LaneMask, VectorMultiplyAdd(DotX, AXX, VectorMultiply(DotY, AYX)), X);
+			Y = VectorSelect(LaneMask, VectorMultiplyAdd(DotX, AXY, VectorMultiply(DotY, AYY)), Y);
+			Z = VectorSelect(LaneMask, VectorMultiplyAdd(DotX, AXZ, VectorMultiply(DotY, AYZ)), Z);
+			StoreTransposed(X, Y, Z, Vectors + i);
+		}
+
+		for (; i < Num; ++i)
+		{
+			if (Mask[i])
+			{
+				const VectorRegister Result = ProjectOnAxes(VectorLoadFloat3_W0(&Vectors[i]), VectorLoadFloat3_W0(&AxesX[i]), VectorLoadFloat3_W0(&AxesY[i]));
+				VectorStoreFloat3(Result, &Vectors[i]);
+			}
+		}
+	}
+}
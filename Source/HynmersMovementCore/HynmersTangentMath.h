@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/VectorRegister.h"
+
+/*
+ * Tangent frame projections of the movement component on vector registers.
+ * Inputs are loaded with W = 0 so the 4 wide dot products match the FVector ones.
+ */
+namespace HynmersTangentMath
+{
+	// V - (V|Normal)*Normal
+	FORCEINLINE VectorRegister ProjectOnPlane(const VectorRegister& V, const VectorRegister& Normal)
+	{
+		return VectorSubtract(V, VectorMultiply(VectorDot3(V, Normal), Normal));
+	}
+
+	// (V|AxisX)*AxisX + (V|AxisY)*AxisY
+	FORCEINLINE VectorRegister ProjectOnAxes(const VectorRegister& V, const VectorRegister& AxisX, const VectorRegister& AxisY)
+	{
+		return VectorMultiplyAdd(VectorDot3(V, AxisX), AxisX, VectorMultiply(VectorDot3(V, AxisY), AxisY));
+	}
+
+	FORCEINLINE FVector ProjectOnPlane(const FVector& V, const FVector& Normal)
+	{
+		FVector Result;
+		VectorStoreFloat3(ProjectOnPlane(VectorLoadFloat3_W0(&V), VectorLoadFloat3_W0(&Normal)), &Result);
+		return Result;
+	}
+
+	FORCEINLINE FVector ProjectOnAxes(const FVector& V, const FVector& AxisX, const FVector& AxisY)
+	{
+		FVector Result;
+		VectorStoreFloat3(ProjectOnAxes(VectorLoadFloat3_W0(&V), VectorLoadFloat3_W0(&AxisX), VectorLoadFloat3_W0(&AxisY)), &Result);
+		return Result;
+	}
+
+	// Projection on the tangent axes with NormalValue along Up
+	FORCEINLINE FVector ProjectOnAxes(const FVector& V, const FVector& AxisX, const FVector& AxisY, const FVector& Up, float NormalValue)
+	{
+		const VectorRegister Tangent = ProjectOnAxes(VectorLoadFloat3_W0(&V), VectorLoadFloat3_W0(&AxisX), VectorLoadFloat3_W0(&AxisY));
+
+		FVector Result;
+		VectorStoreFloat3(VectorMultiplyAdd(VectorSetFloat1(NormalValue), VectorLoadFloat3_W0(&Up), Tangent), &Result);
+		return Result;
+	}
+
+	// Normalized projection on the plane, zero when V is along Normal
+	FORCEINLINE FVector ProjectOnPlaneSafeNormal(const FVector& V, const FVector& Normal)
+	{
+		return ProjectOnPlane(V, Normal).GetSafeNormal();
+	}
+
+	// Batched ProjectOnPlane of Vectors[i] on Normals[i], in place, for the entries where Mask[i] is set.
+	// Four entries at a time, transposed to one register per component, the mask selects the lanes written back.
+	HYNMERSMOVEMENTCORE_API void ProjectOnPlaneBatch(FVector* Vectors, const FVector* Normals, const uint8* Mask, int32 Num);
+
+	// Batched ProjectOnAxes, in place
+	HYNMERSMOVEMENTCORE_API void ProjectOnAxesBatch(FVector* Vectors, const FVector* AxesX, const FVector* AxesY, const uint8* Mask, int32 Num);
+}
@@ -0,0 +1,13 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+using UnrealBuildTool;
+
+public class HynmersMovementMicro : ModuleRules
+{
+	public HynmersMovementMicro(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PrivateIncludePaths.Add("Runtime/Launch/Public");
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "Core", "Projects", "HynmersMovementCore" });
+	}
+}
@@ -0,0 +1,246 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementCore.h"
+#include "HynmersMovementCoreRecorder.h"
+#include "HynmersTangentMath.h"
+
+#include "RequiredProgramMainCPPInclude.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+/*
+ * Standalone timing of the HynmersMovementCore kernels, without the engine, a world or a commandlet.
+ * HynmersMovementMicro [-Inputs=4096] [-Iterations=256] [-Seed=1] [-Replay=<file>] [-Out=<path without extension>]
+ * -Replay also times every kernel on the calls recorded in a game with Hynmers.RecordCoreInputs.
+ */
+IMPLEMENT_APPLICATION(HynmersMovementMicro, "HynmersMovementMicro");
+
+DEFINE_LOG_CATEGORY_STATIC(LogHynmersMovementMicro, Log, All);
+
+namespace HynmersMovementMicro
+{
+	struct FMicroInput
+	{
+		FHynmersMovementFrame Frame;
+		FVector Delta;
+		FVector Slide;
+		FVector Normal;
+		FVector OldNormal;
+		float Time;
+	};
+
+	static void MakeMicroInputs(int32 Seed, int32 Num, TArray<FMicroInput>& OutInputs)
+	{
+		FRandomStream Random(Seed);
+		OutInputs.SetNum(Num);
+		for (FMicroInput& Input : OutInputs)
+		{
+			const FQuat Orientation = FRotationMatrix::MakeFromZX(Random.GetUnitVector(), Random.GetUnitVector()).ToQuat();
+			Input.Frame.Up = Orientation.GetUpVector();
+			Input.Frame.Forward = Orientation.GetForwardVector();
+			Input.Frame.Right = Orientation.GetRightVector();
+			Input.Delta = Random.GetUnitVector() * Random.FRandRange(0.f, 20.f);
+			Input.Slide = Random.GetUnitVector() * Random.FRandRange(0.f, 20.f);
+			Input.Normal = Random.GetUnitVector();
+			Input.OldNormal = Random.GetUnitVector();
+			Input.Time = Random.FRand();
+		}
+	}
+
+	// Runs Kernel over every input Iterations times, returns ns per call
+	template<typename KernelType>
+	static double MeasureKernel(const TArray<FMicroInput>& Inputs, int32 Iterations, float& Sink, KernelType Kernel)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			for (const FMicroInput& Input : Inputs)
+			{
+				Sink += Kernel(Input);
+			}
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1e9 / ((double)Inputs.Num() * Iterations);
+	}
+
+	// Batch kernel over every input Iterations times, returns ns per entry
+	template<typename KernelType>
+	static double MeasureBatch(int32 Num, int32 Iterations, KernelType Kernel)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			Kernel();
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1e9 / ((double)Num * Iterations);
+	}
+
+	// Recorded calls of each kernel, timed apart so every kernel runs on its own inputs
+	static bool MeasureRecorded(const FString& Filename, int32 Iterations, float& Sink, TArray<TPair<FString, double>>& OutResults)
+	{
+		TArray<FHynmersCoreCall> Calls;
+		if (!FHynmersCoreRecorder::LoadFromFile(Filename, Calls))
+		{
+			return false;
+		}
+
+		TArray<FHynmersCoreCall> KernelCalls[(int32)EHynmersCoreKernel::Num];
+		for (const FHynmersCoreCall& Call : Calls)
+		{
+			KernelCalls[Call.Kernel].Add(Call);
+		}
+
+		for (int32 Kernel = 0; Kernel < (int32)EHynmersCoreKernel::Num; ++Kernel)
+		{
+			const TArray<FHynmersCoreCall>& Inputs = KernelCalls[Kernel];
+			if (Inputs.Num() == 0)
+			{
+				continue;
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				for (const FHynmersCoreCall& Call : Inputs)
+				{
+					Sink += FHynmersCoreRecorder::Replay(Call);
+				}
+			}
+			const double NsPerOp = (FPlatformTime::Seconds() - StartTime) * 1e9 / ((double)Inputs.Num() * Iterations);
+			OutResults.Emplace(FString::Printf(TEXT("%sRecorded"), FHynmersCoreRecorder::GetKernelName(Kernel)), NsPerOp);
+		}
+		return true;
+	}
+
+	// HynmersMovementCore kernels on randomized and recorded inputs, no world involved
+	static int32 Run(const TCHAR* Params)
+	{
+		FString OutPath = FPaths::ProjectSavedDir() / TEXT("MovementBenchmark") / FString::Printf(TEXT("Micro-%s"), *FDateTime::Now().ToString());
+		FParse::Value(Params, TEXT("Out="), OutPath);
+
+		int32 NumInputs = 4096;
+		int32 Iterations = 256;
+		int32 Seed = 1;
+		FParse::Value(Params, TEXT("Inputs="), NumInputs);
+		FParse::Value(Params, TEXT("Iterations="), Iterations);
+		FParse::Value(Params, TEXT("Seed="), Seed);
+
+		TArray<FMicroInput> Inputs;
+		MakeMicroInputs(Seed, FMath::Max(NumInputs, 1), Inputs);
+		Iterations = FMath::Max(Iterations, 1);
+
+		// Results are summed so the calls can't be optimized away
+		float Sink = 0.f;
+		TArray<TPair<FString, double>> Results;
+		Results.Emplace(TEXT("ComputeGroundMovementDelta"), MeasureKernel(Inputs, Iterations, Sink, [](const FMicroInput& Input)
+		{
+			return HynmersMovementCore::ComputeGroundMovementDelta(Input.Frame, Input.Delta, Input.Normal, Input.OldNormal, true, true).X;
+		}));
+		Results.Emplace(TEXT("HandleSlopeBoosting"), MeasureKernel(Inputs, Iterations, Sink, [](const FMicroInput& Input)
+		{
+			return HynmersMovementCore::HandleSlopeBoosting(Input.Frame, Input.Slide, Input.Delta, Input.Time, Input.Normal).X;
+		}));
+		Results.Emplace(TEXT("TwoWallAdjust"), MeasureKernel(Inputs, Iterations, Sink, [](const FMicroInput& Input)
+		{
+			FVector Delta = Input.Delta;
+			HynmersMovementCore::TwoWallAdjust(Input.Frame, Delta, Input.Time, Input.Normal, Input.OldNormal, true, Input.Time > 0.5f, false);
+			return Delta.X;
+		}));
+		Results.Emplace(TEXT("IsWithinEdgeTolerance"), MeasureKernel(Inputs, Iterations, Sink, [](const FMicroInput& Input)
+		{
+			return HynmersMovementCore::IsWithinEdgeTolerance(Input.Frame.Up, Input.Delta, Input.Slide, 42.f) ? 1.f : 0.f;
+		}));
+		Results.Emplace(TEXT("LimitAirControl"), MeasureKernel(Inputs, Iterations, Sink, [](const FMicroInput& Input)
+		{
+			return HynmersMovementCore::LimitAirControl(Input.Frame, Input.Delta, Input.Normal, true, true, false).X;
+		}));
+		Results.Emplace(TEXT("IsWalkableNormal"), MeasureKernel(Inputs, Iterations, Sink, [](const FMicroInput& Input)
+		{
+			return HynmersMovementCore::IsWalkableNormal(Input.Normal, Input.Frame.Up, 0.71f) ? 1.f : 0.f;
+		}));
+
+		// Tangent projections of the manager batch, half of the entries masked out, against the per entry loop they replace
+		const int32 Num = Inputs.Num();
+		TArray<FVector> Vectors, Normals, AxesX, AxesY;
+		TArray<uint8> Mask;
+		Vectors.SetNumUninitialized(Num);
+		Normals.SetNumUninitialized(Num);
+		AxesX.SetNumUninitialized(Num);
+		AxesY.SetNumUninitialized(Num);
+		Mask.SetNumUninitialized(Num);
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Vectors[i] = Inputs[i].Delta;
+			Normals[i] = Inputs[i].Frame.Up;
+			AxesX[i] = Inputs[i].Frame.Forward;
+			AxesY[i] = Inputs[i].Frame.Right;
+			Mask[i] = Inputs[i].Time > 0.5f;
+		}
+		Results.Emplace(TEXT("ProjectOnPlaneLoop"), MeasureBatch(Num, Iterations, [&]()
+		{
+			for (int32 i = 0; i < Num; ++i)
+			{
+				if (Mask[i])
+				{
+					Vectors[i] = HynmersTangentMath::ProjectOnPlane(Vectors[i], Normals[i]);
+				}
+			}
+		}));
+		Results.Emplace(TEXT("ProjectOnPlaneBatch"), MeasureBatch(Num, Iterations, [&]()
+		{
+			HynmersTangentMath::ProjectOnPlaneBatch(Vectors.GetData(), Normals.GetData(), Mask.GetData(), Num);
+		}));
+		Results.Emplace(TEXT("ProjectOnAxesLoop"), MeasureBatch(Num, Iterations, [&]()
+		{
+			for (int32 i = 0; i < Num; ++i)
+			{
+				if (Mask[i])
+				{
+					Vectors[i] = HynmersTangentMath::ProjectOnAxes(Vectors[i], AxesX[i], AxesY[i]);
+				}
+			}
+		}));
+		Results.Emplace(TEXT("ProjectOnAxesBatch"), MeasureBatch(Num, Iterations, [&]()
+		{
+			HynmersTangentMath::ProjectOnAxesBatch(Vectors.GetData(), AxesX.GetData(), AxesY.GetData(), Mask.GetData(), Num);
+		}));
+		Sink += Vectors[0].X;
+
+		FString ReplayFilename;
+		if (FParse::Value(Params, TEXT("Replay="), ReplayFilename) && !MeasureRecorded(ReplayFilename, Iterations, Sink, Results))
+		{
+			UE_LOG(LogHynmersMovementMicro, Error, TEXT("Could not load the recorded calls %s"), *ReplayFilename);
+			return 1;
+		}
+
+		FString Csv = TEXT("Kernel,NsPerOp\n");
+		FString Json = FString::Printf(TEXT("{\n\t\"Inputs\": %d,\n\t\"Iterations\": %d,\n\t\"Kernels\": {\n"), Inputs.Num(), Iterations);
+		for (int32 i = 0; i < Results.Num(); ++i)
+		{
+			UE_LOG(LogHynmersMovementMicro, Display, TEXT("%s: %.2f ns/op"), *Results[i].Key, Results[i].Value);
+			Csv += FString::Printf(TEXT("%s,%.3f\n"), *Results[i].Key, Results[i].Value);
+			Json += FString::Printf(TEXT("\t\t\"%s\": %.3f%s\n"), *Results[i].Key, Results[i].Value, i + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+		}
+		Json += TEXT("\t}\n}\n");
+		UE_LOG(LogHynmersMovementMicro, Verbose, TEXT("Checksum %f"), Sink);
+
+		if (!FFileHelper::SaveStringToFile(Csv, *(OutPath + TEXT(".csv"))) || !FFileHelper::SaveStringToFile(Json, *(OutPath + TEXT(".json"))))
+		{
+			UE_LOG(LogHynmersMovementMicro, Error, TEXT("Could not write the report to %s"), *OutPath);
+			return 1;
+		}
+		return 0;
+	}
+}
+
+INT32_MAIN_INT32_ARGC_TCHAR_ARGV()
+{
+	GEngineLoop.PreInit(ArgC, ArgV);
+
+	const int32 Result = HynmersMovementMicro::Run(FCommandLine::Get());
+
+	FEngineLoop::AppPreExit();
+	FEngineLoop::AppExit();
+	return Result;
+}
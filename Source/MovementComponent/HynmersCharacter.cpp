@@ -13,6 +13,7 @@
 #include "Kismet/GameplayStatics.h"
 #include "MotionControllerComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "Net/UnrealNetwork.h"
 
 
 
@@ -78,6 +79,83 @@ void AHynmersCharacter::Tick(float DeltaTime)
 	//UE_LOG(LogTemp,Warning,TEXT("Im ticking"))
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Replication
+
+void AHynmersCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(AHynmersCharacter, PackedMovement, COND_SimulatedOnly);
+}
+
+void AHynmersCharacter::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	// Physics simulation still needs the full FRepMovement
+	const bool bUsePackedMovement = bReplicateMovement && !ReplicatedMovement.bRepPhysics;
+	if (bUsePackedMovement)
+	{
+		PackedMovement.Pack(ReplicatedMovement.Location, ReplicatedMovement.Rotation.Quaternion(), ReplicatedMovement.LinearVelocity);
+	}
+
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AActor, ReplicatedMovement, bReplicateMovement && !bUsePackedMovement);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AHynmersCharacter, PackedMovement, bUsePackedMovement);
+}
+
+void AHynmersCharacter::OnRep_PackedMovement()
+{
+	FQuat Rotation;
+	FVector UpVector;
+	PackedMovement.Unpack(ReplicatedMovement.Location, Rotation, ReplicatedMovement.LinearVelocity, UpVector);
+	ReplicatedMovement.Rotation = Rotation.Rotator();
+	ReplicatedMovement.AngularVelocity = FVector::ZeroVector;
+	ReplicatedMovement.bRepPhysics = false;
+
+	OnRep_ReplicatedMovement();
+}
+
+void AHynmersCharacter::ServerMovePacked_Implementation(float TimeStamp, FHynmersPackedAcceleration InAccel, FVector_NetQuantize100 ClientLoc, uint8 CompressedMoveFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	GetCharacterMovement()->ServerMove_Implementation(TimeStamp, InAccel.Unpack(), ClientLoc, CompressedMoveFlags, ClientRoll, View, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+}
+
+bool AHynmersCharacter::ServerMovePacked_Validate(float TimeStamp, FHynmersPackedAcceleration InAccel, FVector_NetQuantize100 ClientLoc, uint8 CompressedMoveFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	return GetCharacterMovement()->ServerMove_Validate(TimeStamp, InAccel.Unpack(), ClientLoc, CompressedMoveFlags, ClientRoll, View, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+}
+
+void AHynmersCharacter::ServerMoveDualPacked_Implementation(float TimeStamp0, FHynmersPackedAcceleration InAccel0, uint8 PendingFlags, uint32 View0, float TimeStamp, FHynmersPackedAcceleration InAccel, FVector_NetQuantize100 ClientLoc, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	GetCharacterMovement()->ServerMoveDual_Implementation(TimeStamp0, InAccel0.Unpack(), PendingFlags, View0, TimeStamp, InAccel.Unpack(), ClientLoc, NewFlags, ClientRoll, View, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+}
+
+bool AHynmersCharacter::ServerMoveDualPacked_Validate(float TimeStamp0, FHynmersPackedAcceleration InAccel0, uint8 PendingFlags, uint32 View0, float TimeStamp, FHynmersPackedAcceleration InAccel, FVector_NetQuantize100 ClientLoc, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	return GetCharacterMovement()->ServerMoveDual_Validate(TimeStamp0, InAccel0.Unpack(), PendingFlags, View0, TimeStamp, InAccel.Unpack(), ClientLoc, NewFlags, ClientRoll, View, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+}
+
+void AHynmersCharacter::ServerMoveDualHybridRootMotionPacked_Implementation(float TimeStamp0, FHynmersPackedAcceleration InAccel0, uint8 PendingFlags, uint32 View0, float TimeStamp, FHynmersPackedAcceleration InAccel, FVector_NetQuantize100 ClientLoc, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	GetCharacterMovement()->ServerMoveDualHybridRootMotion_Implementation(TimeStamp0, InAccel0.Unpack(), PendingFlags, View0, TimeStamp, InAccel.Unpack(), ClientLoc, NewFlags, ClientRoll, View, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+}
+
+bool AHynmersCharacter::ServerMoveDualHybridRootMotionPacked_Validate(float TimeStamp0, FHynmersPackedAcceleration InAccel0, uint8 PendingFlags, uint32 View0, float TimeStamp, FHynmersPackedAcceleration InAccel, FVector_NetQuantize100 ClientLoc, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	return GetCharacterMovement()->ServerMoveDualHybridRootMotion_Validate(TimeStamp0, InAccel0.Unpack(), PendingFlags, View0, TimeStamp, InAccel.Unpack(), ClientLoc, NewFlags, ClientRoll, View, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+}
+
+void AHynmersCharacter::ServerMoveOldPacked_Implementation(float OldTimeStamp, FHynmersPackedAcceleration OldAccel, uint8 OldMoveFlags)
+{
+	GetCharacterMovement()->ServerMoveOld_Implementation(OldTimeStamp, OldAccel.Unpack(), OldMoveFlags);
+}
+
+bool AHynmersCharacter::ServerMoveOldPacked_Validate(float OldTimeStamp, FHynmersPackedAcceleration OldAccel, uint8 OldMoveFlags)
+{
+	return GetCharacterMovement()->ServerMoveOld_Validate(OldTimeStamp, OldAccel.Unpack(), OldMoveFlags);
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Input
 
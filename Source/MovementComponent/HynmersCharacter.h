@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "HynmersNetQuantize.h"
 #include "HynmersCharacter.generated.h"
 
 class UInputComponent;
@@ -39,6 +40,35 @@ protected:
 
 	virtual void Tick(float DeltaTime) override;
 
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	// ServerMove with the acceleration packed relative to the client up vector
+	UFUNCTION(unreliable, server, WithValidation)
+	void ServerMovePacked(float TimeStamp, FHynmersPackedAcceleration InAccel, FVector_NetQuantize100 ClientLoc, uint8 CompressedMoveFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
+
+	// ServerMoveDual with both accelerations packed
+	UFUNCTION(unreliable, server, WithValidation)
+	void ServerMoveDualPacked(float TimeStamp0, FHynmersPackedAcceleration InAccel0, uint8 PendingFlags, uint32 View0, float TimeStamp, FHynmersPackedAcceleration InAccel, FVector_NetQuantize100 ClientLoc, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
+
+	// ServerMoveDualHybridRootMotion with both accelerations packed
+	UFUNCTION(unreliable, server, WithValidation)
+	void ServerMoveDualHybridRootMotionPacked(float TimeStamp0, FHynmersPackedAcceleration InAccel0, uint8 PendingFlags, uint32 View0, float TimeStamp, FHynmersPackedAcceleration InAccel, FVector_NetQuantize100 ClientLoc, uint8 NewFlags, uint8 ClientRoll, uint32 View, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode);
+
+	// ServerMoveOld with the acceleration packed
+	UFUNCTION(unreliable, server, WithValidation)
+	void ServerMoveOldPacked(float OldTimeStamp, FHynmersPackedAcceleration OldAccel, uint8 OldMoveFlags);
+
+protected:
+	// Replaces ReplicatedMovement for simulated proxies while the character does not simulate physics
+	UPROPERTY(ReplicatedUsing = OnRep_PackedMovement)
+	FHynmersPackedMovement PackedMovement;
+
+	UFUNCTION()
+	void OnRep_PackedMovement();
+
 public:
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
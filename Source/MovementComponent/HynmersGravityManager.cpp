@@ -0,0 +1,299 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersGravityManager.h"
+#include "HynmersGravitySourceComponent.h"
+
+#include "Engine/World.h"
+
+namespace HynmersGravity
+{
+	static TMap<TWeakObjectPtr<const UWorld>, TWeakObjectPtr<AHynmersGravityManager>> WorldManagers;
+}
+
+AHynmersGravityManager::AHynmersGravityManager()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+}
+
+void AHynmersGravityManager::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	HynmersGravity::WorldManagers.Add(GetWorld(), this);
+}
+
+void AHynmersGravityManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	const TWeakObjectPtr<AHynmersGravityManager>* Registered = HynmersGravity::WorldManagers.Find(GetWorld());
+	if (Registered && Registered->Get() == this)
+	{
+		HynmersGravity::WorldManagers.Remove(GetWorld());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+AHynmersGravityManager* AHynmersGravityManager::Find(const UWorld* World)
+{
+	const TWeakObjectPtr<AHynmersGravityManager>* Registered = World ? HynmersGravity::WorldManagers.Find(World) : nullptr;
+	return Registered ? Registered->Get() : nullptr;
+}
+
+AHynmersGravityManager* AHynmersGravityManager::FindOrSpawn(UWorld* World)
+{
+	AHynmersGravityManager* Manager = Find(World);
+	if (!Manager && World && World->IsGameWorld())
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		Manager = World->SpawnActor<AHynmersGravityManager>(SpawnParams);
+	}
+	return Manager;
+}
+
+void AHynmersGravityManager::RegisterSource(UHynmersGravitySourceComponent* Source)
+{
+	if (Source->IsUnbounded())
+	{
+		UnboundedSources.AddUnique(Source);
+	}
+	else
+	{
+		BoundedSources.AddUnique(Source);
+		bTreeDirty = true;
+	}
+	QueryCacheFrame = 0;
+}
+
+void AHynmersGravityManager::UnregisterSource(UHynmersGravitySourceComponent* Source)
+{
+	UnboundedSources.Remove(Source);
+	if (BoundedSources.Remove(Source) > 0)
+	{
+		bTreeDirty = true;
+	}
+	QueryCacheFrame = 0;
+}
+
+void AHynmersGravityManager::MarkBoundsDirty()
+{
+	bBoundsDirty = true;
+	QueryCacheFrame = 0;
+}
+
+bool AHynmersGravityManager::QueryGravity(const FVector& Location, FVector& OutGravity)
+{
+	if (bTreeDirty)
+	{
+		RebuildTree();
+	}
+	else if (bBoundsDirty)
+	{
+		RefitTree();
+	}
+
+	// Characters inside the same cell during the same frame share the result
+	if (QueryCacheFrame != GFrameCounter)
+	{
+		QueryCache.Reset();
+		QueryCacheFrame = GFrameCounter;
+	}
+
+	const float InvCellSize = 1.f / FMath::Max(QueryCellSize, 1.f);
+	const FIntVector Cell(FMath::FloorToInt(Location.X * InvCellSize), FMath::FloorToInt(Location.Y * InvCellSize), FMath::FloorToInt(Location.Z * InvCellSize));
+
+	if (const FCachedQuery* Cached = QueryCache.Find(Cell))
+	{
+		OutGravity = Cached->Gravity;
+		return Cached->bHasGravity;
+	}
+
+	// Evaluate at the cell center so every character in the cell gets the same answer
+	const FVector CellCenter = (FVector(Cell.X, Cell.Y, Cell.Z) + FVector(0.5f)) * QueryCellSize;
+
+	FCachedQuery& NewQuery = QueryCache.Add(Cell);
+	NewQuery.bHasGravity = EvaluateSources(CellCenter, NewQuery.Gravity);
+
+	OutGravity = NewQuery.Gravity;
+	return NewQuery.bHasGravity;
+}
+
+void AHynmersGravityManager::RebuildTree()
+{
+	bTreeDirty = false;
+	bBoundsDirty = false;
+
+	SortedSources.Reset();
+	Nodes.Reset();
+
+	for (int32 i = BoundedSources.Num() - 1; i >= 0; --i)
+	{
+		UHynmersGravitySourceComponent* Source = BoundedSources[i].Get();
+		if (!Source)
+		{
+			BoundedSources.RemoveAtSwap(i);
+			continue;
+		}
+		SortedSources.Add({ Source, Source->GetInfluenceBounds() });
+	}
+
+	if (SortedSources.Num() > 0)
+	{
+		Nodes.Reserve(2 * SortedSources.Num());
+		BuildNode(0, SortedSources.Num());
+	}
+}
+
+int32 AHynmersGravityManager::BuildNode(int32 First, int32 Count)
+{
+	const int32 NodeIndex = Nodes.AddUninitialized();
+
+	FBox Bounds(ForceInit);
+	FBox CenterBounds(ForceInit);
+	for (int32 i = First; i < First + Count; ++i)
+	{
+		Bounds += SortedSources[i].Bounds;
+		CenterBounds += SortedSources[i].Bounds.GetCenter();
+	}
+
+	Nodes[NodeIndex].Bounds = Bounds;
+	Nodes[NodeIndex].First = First;
+	Nodes[NodeIndex].Count = Count;
+	Nodes[NodeIndex].Left = INDEX_NONE;
+	Nodes[NodeIndex].Right = INDEX_NONE;
+
+	if (Count <= MaxLeafSources)
+	{
+		return NodeIndex;
+	}
+
+	// Median split along the longest axis of the centers
+	const FVector Extent = CenterBounds.GetSize();
+	const int32 Axis = (Extent.X >= Extent.Y && Extent.X >= Extent.Z) ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+
+	FSourceEntry* Range = SortedSources.GetData() + First;
+	Sort(Range, Count, [Axis](const FSourceEntry& A, const FSourceEntry& B)
+	{
+		return A.Bounds.GetCenter()[Axis] < B.Bounds.GetCenter()[Axis];
+	});
+
+	const int32 LeftCount = Count / 2;
+	const int32 Left = BuildNode(First, LeftCount);
+	const int32 Right = BuildNode(First + LeftCount, Count - LeftCount);
+
+	// Nodes may have been reallocated by the recursion
+	Nodes[NodeIndex].Left = Left;
+	Nodes[NodeIndex].Right = Right;
+	Nodes[NodeIndex].Count = 0;
+
+	return NodeIndex;
+}
+
+void AHynmersGravityManager::RefitTree()
+{
+	bBoundsDirty = false;
+
+	for (FSourceEntry& Entry : SortedSources)
+	{
+		Entry.Bounds = Entry.Source->GetInfluenceBounds();
+	}
+
+	if (Nodes.Num() > 0)
+	{
+		RefitNode(0);
+	}
+}
+
+void AHynmersGravityManager::RefitNode(int32 NodeIndex)
+{
+	FNode& Node = Nodes[NodeIndex];
+
+	if (Node.Left == INDEX_NONE)
+	{
+		Node.Bounds.Init();
+		for (int32 i = Node.First; i < Node.First + Node.Count; ++i)
+		{
+			Node.Bounds += SortedSources[i].Bounds;
+		}
+		return;
+	}
+
+	RefitNode(Node.Left);
+	RefitNode(Node.Right);
+	Nodes[NodeIndex].Bounds = Nodes[Node.Left].Bounds + Nodes[Node.Right].Bounds;
+}
+
+bool AHynmersGravityManager::EvaluateSources(const FVector& Location, FVector& OutGravity) const
+{
+	OutGravity = FVector::ZeroVector;
+	int32 BestPriority = MIN_int32;
+	bool bFound = false;
+
+	if (Nodes.Num() > 0)
+	{
+		TArray<int32, TInlineAllocator<32>> Stack;
+		Stack.Add(0);
+
+		while (Stack.Num() > 0)
+		{
+			const FNode& Node = Nodes[Stack.Pop(false)];
+			if (!Node.Bounds.IsInside(Location))
+			{
+				continue;
+			}
+
+			if (Node.Left == INDEX_NONE)
+			{
+				for (int32 i = Node.First; i < Node.First + Node.Count; ++i)
+				{
+					if (SortedSources[i].Bounds.IsInside(Location))
+					{
+						Accumulate(SortedSources[i].Source, Location, BestPriority, OutGravity, bFound);
+					}
+				}
+			}
+			else
+			{
+				Stack.Add(Node.Left);
+				Stack.Add(Node.Right);
+			}
+		}
+	}
+
+	for (const TWeakObjectPtr<UHynmersGravitySourceComponent>& Source : UnboundedSources)
+	{
+		if (Source.IsValid())
+		{
+			Accumulate(Source.Get(), Location, BestPriority, OutGravity, bFound);
+		}
+	}
+
+	return bFound && !OutGravity.IsNearlyZero();
+}
+
+void AHynmersGravityManager::Accumulate(const UHynmersGravitySourceComponent* Source, const FVector& Location, int32& BestPriority, FVector& OutGravity, bool& bOutFound) const
+{
+	if (Source->Priority < BestPriority)
+	{
+		return;
+	}
+
+	FVector SourceGravity;
+	if (!Source->ComputeGravity(Location, SourceGravity))
+	{
+		return;
+	}
+
+	if (Source->Priority > BestPriority)
+	{
+		BestPriority = Source->Priority;
+		OutGravity = SourceGravity;
+	}
+	else
+	{
+		OutGravity += SourceGravity;
+	}
+	bOutFound = true;
+}
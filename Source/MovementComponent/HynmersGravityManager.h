@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "HynmersGravityManager.generated.h"
+
+class UHynmersGravitySourceComponent;
+
+/*
+ * Per world registry of gravity sources.
+ * Bounded sources are indexed in a BVH so a character lookup is O(log n), and lookups
+ * are cached per frame in a coarse grid so characters standing close share one query.
+ */
+UCLASS(NotPlaceable, Transient)
+class MOVEMENTCOMPONENT_API AHynmersGravityManager : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AHynmersGravityManager();
+
+	virtual void PostInitializeComponents() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Manager of the world, or null if no gravity source has been registered in it.
+	static AHynmersGravityManager* Find(const UWorld* World);
+
+	static AHynmersGravityManager* FindOrSpawn(UWorld* World);
+
+	void RegisterSource(UHynmersGravitySourceComponent* Source);
+
+	void UnregisterSource(UHynmersGravitySourceComponent* Source);
+
+	// Sources bounds changed, the tree only needs a refit.
+	void MarkBoundsDirty();
+
+	// Returns true if any source affects the location, with the resulting acceleration in OutGravity.
+	bool QueryGravity(const FVector& Location, FVector& OutGravity);
+
+	// Size of the cells used to share query results between characters
+	UPROPERTY(Category = "Gravity", EditAnywhere)
+		float QueryCellSize = 50.f;
+
+private:
+	struct FNode
+	{
+		FBox Bounds;
+		// Children for inner nodes, INDEX_NONE for leaves
+		int32 Left;
+		int32 Right;
+		// Range in SortedSources for leaves
+		int32 First;
+		int32 Count;
+	};
+
+	struct FSourceEntry
+	{
+		UHynmersGravitySourceComponent* Source;
+		FBox Bounds;
+	};
+
+	struct FCachedQuery
+	{
+		FVector Gravity;
+		bool bHasGravity;
+	};
+
+	void RebuildTree();
+
+	void RefitTree();
+
+	int32 BuildNode(int32 First, int32 Count);
+
+	void RefitNode(int32 NodeIndex);
+
+	bool EvaluateSources(const FVector& Location, FVector& OutGravity) const;
+
+	void Accumulate(const UHynmersGravitySourceComponent* Source, const FVector& Location, int32& BestPriority, FVector& OutGravity, bool& bOutFound) const;
+
+	TArray<TWeakObjectPtr<UHynmersGravitySourceComponent>> BoundedSources;
+
+	TArray<TWeakObjectPtr<UHynmersGravitySourceComponent>> UnboundedSources;
+
+	// Bounded sources reordered by the tree build
+	TArray<FSourceEntry> SortedSources;
+
+	TArray<FNode> Nodes;
+
+	TMap<FIntVector, FCachedQuery> QueryCache;
+
+	uint64 QueryCacheFrame = 0;
+
+	bool bTreeDirty = true;
+
+	bool bBoundsDirty = false;
+
+	static const int32 MaxLeafSources = 2;
+};
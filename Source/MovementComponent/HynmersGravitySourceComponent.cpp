@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersGravitySourceComponent.h"
+#include "HynmersGravityManager.h"
+
+#include "Components/SplineComponent.h"
+#include "GameFramework/Actor.h"
+
+UHynmersGravitySourceComponent::UHynmersGravitySourceComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+	bWantsOnUpdateTransform = true;
+}
+
+void UHynmersGravitySourceComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (AHynmersGravityManager* Manager = AHynmersGravityManager::FindOrSpawn(GetWorld()))
+	{
+		Manager->RegisterSource(this);
+		bRegistered = true;
+
+		if (Shape == EHynmersGravityShape::Spline)
+		{
+			SplineBounds = GetInfluenceBounds();
+			SetComponentTickEnabled(true);
+		}
+	}
+}
+
+void UHynmersGravitySourceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bRegistered)
+	{
+		if (AHynmersGravityManager* Manager = GetManager())
+		{
+			Manager->UnregisterSource(this);
+		}
+		bRegistered = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UHynmersGravitySourceComponent::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+
+	if (bRegistered)
+	{
+		if (AHynmersGravityManager* Manager = GetManager())
+		{
+			Manager->MarkBoundsDirty();
+		}
+	}
+}
+
+void UHynmersGravitySourceComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!bRegistered || Shape != EHynmersGravityShape::Spline)
+	{
+		return;
+	}
+
+	const FBox Bounds = GetInfluenceBounds();
+	if (!Bounds.Min.Equals(SplineBounds.Min) || !Bounds.Max.Equals(SplineBounds.Max))
+	{
+		SplineBounds = Bounds;
+		if (AHynmersGravityManager* Manager = GetManager())
+		{
+			Manager->MarkBoundsDirty();
+		}
+	}
+}
+
+AHynmersGravityManager* UHynmersGravitySourceComponent::GetManager() const
+{
+	return AHynmersGravityManager::Find(GetWorld());
+}
+
+FBox UHynmersGravitySourceComponent::GetInfluenceBounds() const
+{
+	const FTransform& Transform = GetComponentTransform();
+
+	switch (Shape)
+	{
+	case EHynmersGravityShape::Point:
+		return FBox::BuildAABB(Transform.GetLocation(), FVector(InfluenceRadius));
+
+	case EHynmersGravityShape::Line:
+	{
+		const FVector HalfSegment = Transform.GetUnitAxis(EAxis::X) * LineHalfLength;
+		FBox Bounds(ForceInit);
+		Bounds += Transform.GetLocation() + HalfSegment;
+		Bounds += Transform.GetLocation() - HalfSegment;
+		return Bounds.ExpandBy(InfluenceRadius);
+	}
+
+	case EHynmersGravityShape::Spline:
+	{
+		const USplineComponent* Spline = GetOwner() ? GetOwner()->FindComponentByClass<USplineComponent>() : nullptr;
+		if (Spline)
+		{
+			return Spline->CalcBounds(Spline->GetComponentTransform()).GetBox().ExpandBy(InfluenceRadius);
+		}
+		return FBox(ForceInit);
+	}
+
+	case EHynmersGravityShape::Box:
+		return FBox(-BoxExtent, BoxExtent).TransformBy(Transform);
+
+	default:
+		return FBox(ForceInit);
+	}
+}
+
+bool UHynmersGravitySourceComponent::ComputeGravity(const FVector& Location, FVector& OutGravity) const
+{
+	const FTransform& Transform = GetComponentTransform();
+	FVector Center;
+
+	switch (Shape)
+	{
+	case EHynmersGravityShape::Point:
+		Center = Transform.GetLocation();
+		break;
+
+	case EHynmersGravityShape::Line:
+	{
+		const FVector HalfSegment = Transform.GetUnitAxis(EAxis::X) * LineHalfLength;
+		Center = FMath::ClosestPointOnSegment(Location, Transform.GetLocation() - HalfSegment, Transform.GetLocation() + HalfSegment);
+		break;
+	}
+
+	case EHynmersGravityShape::Spline:
+	{
+		const USplineComponent* Spline = GetOwner() ? GetOwner()->FindComponentByClass<USplineComponent>() : nullptr;
+		if (!Spline)
+		{
+			return false;
+		}
+		Center = Spline->FindLocationClosestToWorldLocation(Location, ESplineCoordinateSpace::World);
+		break;
+	}
+
+	case EHynmersGravityShape::Box:
+	{
+		const FVector LocalLocation = Transform.InverseTransformPosition(Location);
+		if (FMath::Abs(LocalLocation.X) > BoxExtent.X || FMath::Abs(LocalLocation.Y) > BoxExtent.Y || FMath::Abs(LocalLocation.Z) > BoxExtent.Z)
+		{
+			return false;
+		}
+		OutGravity = -Transform.GetUnitAxis(EAxis::Z) * Strength;
+		return true;
+	}
+
+	case EHynmersGravityShape::Directional:
+		OutGravity = -Transform.GetUnitAxis(EAxis::Z) * Strength;
+		return true;
+
+	default:
+		return false;
+	}
+
+	// Radial sources
+	const FVector ToCenter = Center - Location;
+	const float DistSq = ToCenter.SizeSquared();
+	if (DistSq > FMath::Square(InfluenceRadius) || DistSq < KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	OutGravity = ToCenter * (FMath::InvSqrt(DistSq) * Strength);
+	return true;
+}
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "HynmersGravitySourceComponent.generated.h"
+
+UENUM(BlueprintType)
+enum class EHynmersGravityShape : uint8
+{
+	// Pulls towards the component location (planets)
+	Point,
+	// Pulls towards the closest point of a segment along the component X axis
+	Line,
+	// Pulls towards the closest point of the first spline component of the owner
+	Spline,
+	// Pulls along the component -Z axis inside an oriented box
+	Box,
+	// Pulls along the component -Z axis everywhere
+	Directional
+};
+
+/*
+ * Gravity source registered in the world gravity manager.
+ */
+UCLASS(ClassGroup = (Movement), meta = (BlueprintSpawnableComponent))
+class MOVEMENTCOMPONENT_API UHynmersGravitySourceComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+	UHynmersGravitySourceComponent();
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport = ETeleportType::None) override;
+
+	// Spline sources only, the spline can be moved or edited without this component knowing
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// World space bounds where this source can affect a character. Not valid for directional sources.
+	FBox GetInfluenceBounds() const;
+
+	// Returns true if the location is affected by this source, with the gravity acceleration in OutGravity.
+	bool ComputeGravity(const FVector& Location, FVector& OutGravity) const;
+
+	bool IsUnbounded() const { return Shape == EHynmersGravityShape::Directional; }
+
+	UPROPERTY(Category = "Gravity", EditAnywhere, BlueprintReadOnly)
+		EHynmersGravityShape Shape = EHynmersGravityShape::Point;
+
+	// Gravity acceleration in cm/s^2
+	UPROPERTY(Category = "Gravity", EditAnywhere, BlueprintReadOnly)
+		float Strength = 980.f;
+
+	// Distance from the point, line or spline where the source stops acting
+	UPROPERTY(Category = "Gravity", EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", UIMin = "0"))
+		float InfluenceRadius = 5000.f;
+
+	// Half length of the segment used by line sources
+	UPROPERTY(Category = "Gravity", EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", UIMin = "0"))
+		float LineHalfLength = 1000.f;
+
+	// Local half extent of box sources
+	UPROPERTY(Category = "Gravity", EditAnywhere, BlueprintReadOnly)
+		FVector BoxExtent = FVector(1000.f);
+
+	// Overlapping sources with higher priority win, sources with the same priority are added
+	UPROPERTY(Category = "Gravity", EditAnywhere, BlueprintReadOnly)
+		int32 Priority = 0;
+
+private:
+	class AHynmersGravityManager* GetManager() const;
+
+	bool bRegistered = false;
+
+	// Influence bounds the manager last saw for a spline source
+	FBox SplineBounds = FBox(ForceInit);
+};
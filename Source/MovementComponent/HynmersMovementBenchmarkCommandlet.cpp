@@ -0,0 +1,177 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementBenchmarkCommandlet.h"
+#include "HynmersCharacter.h"
+#include "HynmersMovementStats.h"
+#include "HynmersMovementTestWorld.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHynmersMovementBenchmark, Log, All);
+
+namespace HynmersMovementBenchmark
+{
+	static const float FrameTime = 1.f / 60.f;
+
+	static float GetPercentile(const TArray<double>& SortedValues, float Percentile)
+	{
+		if (SortedValues.Num() == 0)
+		{
+			return 0.f;
+		}
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+		return (float)SortedValues[Index];
+	}
+
+	// Steering changes slowly per character, some characters also jump
+	static void DriveCharacter(AHynmersCharacter* Character, int32 CharacterIndex, int32 Frame)
+	{
+		const float Angle = Frame * 0.02f + CharacterIndex * 0.7f;
+		const FVector Direction = Character->GetActorForwardVector() * FMath::Cos(Angle) + Character->GetActorRightVector() * FMath::Sin(Angle);
+		Character->AddMovementInput(Direction, 1.f);
+
+		if (CharacterIndex % 7 == 0 && (Frame + CharacterIndex) % 120 == 0)
+		{
+			Character->Jump();
+		}
+		else
+		{
+			Character->StopJumping();
+		}
+	}
+}
+
+UHynmersMovementBenchmarkCommandlet::UHynmersMovementBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UHynmersMovementBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace HynmersMovementBenchmark;
+
+	int32 NumCharacters = 256;
+	int32 NumFrames = 600;
+	int32 NumWarmupFrames = 60;
+	FParse::Value(*Params, TEXT("Characters="), NumCharacters);
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("Warmup="), NumWarmupFrames);
+	const bool bUseMovementManager = !FParse::Param(*Params, TEXT("NoManager"));
+	const bool bUseDistanceField = FParse::Param(*Params, TEXT("DistanceField"));
+
+	FString OutPath = FPaths::ProjectSavedDir() / TEXT("MovementBenchmark") / FString::Printf(TEXT("Benchmark-%s"), *FDateTime::Now().ToString());
+	FParse::Value(*Params, TEXT("Out="), OutPath);
+
+	NumCharacters = FMath::Max(NumCharacters, 1);
+	NumFrames = FMath::Max(NumFrames, 1);
+
+	FHynmersMovementTestWorld TestWorld;
+	if (!TestWorld.Initialize())
+	{
+		UE_LOG(LogHynmersMovementBenchmark, Error, TEXT("Could not create the benchmark world"));
+		return 1;
+	}
+
+	// Zones far enough apart for the planets gravity not to overlap
+	TArray<FHynmersTestSpawn> Spawns;
+	TestWorld.BuildFloor(FVector(0.f, 0.f, 0.f), 5000.f, Spawns);
+	TestWorld.BuildStairs(FVector(0.f, 8000.f, 0.f), 20, 30.f, 40.f, 1500.f, Spawns);
+	TestWorld.BuildRamps(FVector(0.f, -8000.f, 0.f), 1500.f, 600.f, Spawns);
+	TestWorld.BuildCubePlanet(FVector(20000.f, 0.f, 0.f), 1500.f, Spawns);
+	TestWorld.BuildSpherePlanet(FVector(-20000.f, 0.f, 0.f), 1500.f, Spawns);
+
+	if (bUseDistanceField)
+	{
+		TestWorld.AddStaticDistanceField();
+	}
+
+	// Zones are cycled so every kind of surface is covered whatever the count
+	TArray<AHynmersCharacter*> Characters;
+	for (int32 i = 0; i < NumCharacters; ++i)
+	{
+		const FHynmersTestSpawn& Spawn = Spawns[(i * 7919) % Spawns.Num()];
+		if (AHynmersCharacter* Character = TestWorld.SpawnCharacter(Spawn, bUseMovementManager))
+		{
+			Characters.Add(Character);
+		}
+	}
+
+	for (int32 Frame = 0; Frame < NumWarmupFrames; ++Frame)
+	{
+		for (int32 i = 0; i < Characters.Num(); ++i)
+		{
+			DriveCharacter(Characters[i], i, Frame);
+		}
+		TestWorld.Tick(FrameTime);
+	}
+
+	FHynmersMovementCounters& Counters = FHynmersMovementCounters::Get();
+	Counters.Reset();
+
+	TArray<double> FrameMilliseconds;
+	FrameMilliseconds.Reserve(NumFrames);
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		for (int32 i = 0; i < Characters.Num(); ++i)
+		{
+			DriveCharacter(Characters[i], i, NumWarmupFrames + Frame);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		TestWorld.Tick(FrameTime);
+		FrameMilliseconds.Add((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
+	double TotalMilliseconds = 0.0;
+	for (double Milliseconds : FrameMilliseconds)
+	{
+		TotalMilliseconds += Milliseconds;
+	}
+	FrameMilliseconds.Sort();
+
+	const float CharacterTicks = (float)FMath::Max(Characters.Num() * NumFrames, 1);
+	const float MeanFrameMs = (float)(TotalMilliseconds / NumFrames);
+	const float P50FrameMs = GetPercentile(FrameMilliseconds, 0.5f);
+	const float P99FrameMs = GetPercentile(FrameMilliseconds, 0.99f);
+	const float MsPerCharacterTick = (float)(TotalMilliseconds / CharacterTicks);
+	const float SweepsPerCharacterTick = Counters.GetTotal(EHynmersMovementCounter::Sweeps) / CharacterTicks;
+	const float LineTracesPerCharacterTick = Counters.GetTotal(EHynmersMovementCounter::LineTraces) / CharacterTicks;
+	const float MovesPerCharacterTick = Counters.GetTotal(EHynmersMovementCounter::MoveComponent) / CharacterTicks;
+	const float IterationsPerCharacterTick = Counters.GetTotal(EHynmersMovementCounter::Iterations) / CharacterTicks;
+	const int32 IterationCaps = Counters.GetTotal(EHynmersMovementCounter::IterationCaps);
+	const float OverlapsPerCharacterTick = Counters.GetTotal(EHynmersMovementCounter::Overlaps) / CharacterTicks;
+	const float FieldFloorsPerCharacterTick = Counters.GetTotal(EHynmersMovementCounter::FieldFloors) / CharacterTicks;
+
+	FString Csv = TEXT("Characters,Frames,MovementManager,MeanFrameMs,P50FrameMs,P99FrameMs,MsPerCharacterTick,SweepsPerCharacterTick,LineTracesPerCharacterTick,MoveComponentPerCharacterTick,IterationsPerCharacterTick,IterationCaps,DistanceField,OverlapsPerCharacterTick,FieldFloorsPerCharacterTick\n");
+	Csv += FString::Printf(TEXT("%d,%d,%d,%.4f,%.4f,%.4f,%.6f,%.3f,%.3f,%.3f,%.3f,%d,%d,%.3f,%.3f\n"),
+		Characters.Num(), NumFrames, bUseMovementManager ? 1 : 0, MeanFrameMs, P50FrameMs, P99FrameMs, MsPerCharacterTick,
+		SweepsPerCharacterTick, LineTracesPerCharacterTick, MovesPerCharacterTick, IterationsPerCharacterTick, IterationCaps,
+		bUseDistanceField ? 1 : 0, OverlapsPerCharacterTick, FieldFloorsPerCharacterTick);
+
+	FString Json = TEXT("{\n");
+	Json += FString::Printf(TEXT("\t\"Characters\": %d,\n\t\"Frames\": %d,\n\t\"MovementManager\": %s,\n"), Characters.Num(), NumFrames, bUseMovementManager ? TEXT("true") : TEXT("false"));
+	Json += FString::Printf(TEXT("\t\"MeanFrameMs\": %.4f,\n\t\"P50FrameMs\": %.4f,\n\t\"P99FrameMs\": %.4f,\n\t\"MsPerCharacterTick\": %.6f,\n"), MeanFrameMs, P50FrameMs, P99FrameMs, MsPerCharacterTick);
+	Json += FString::Printf(TEXT("\t\"SweepsPerCharacterTick\": %.3f,\n\t\"LineTracesPerCharacterTick\": %.3f,\n"), SweepsPerCharacterTick, LineTracesPerCharacterTick);
+	Json += FString::Printf(TEXT("\t\"MoveComponentPerCharacterTick\": %.3f,\n\t\"IterationsPerCharacterTick\": %.3f,\n\t\"IterationCaps\": %d,\n"), MovesPerCharacterTick, IterationsPerCharacterTick, IterationCaps);
+	Json += FString::Printf(TEXT("\t\"DistanceField\": %s,\n\t\"OverlapsPerCharacterTick\": %.3f,\n\t\"FieldFloorsPerCharacterTick\": %.3f\n}\n"),
+		bUseDistanceField ? TEXT("true") : TEXT("false"), OverlapsPerCharacterTick, FieldFloorsPerCharacterTick);
+
+	TestWorld.Shutdown();
+
+	UE_LOG(LogHynmersMovementBenchmark, Display, TEXT("%d characters, %d frames: mean %.3f ms, p50 %.3f ms, p99 %.3f ms, %.4f ms per character tick, %.2f sweeps and %.2f line traces per character tick"),
+		Characters.Num(), NumFrames, MeanFrameMs, P50FrameMs, P99FrameMs, MsPerCharacterTick, SweepsPerCharacterTick, LineTracesPerCharacterTick);
+
+	if (!FFileHelper::SaveStringToFile(Csv, *(OutPath + TEXT(".csv"))) || !FFileHelper::SaveStringToFile(Json, *(OutPath + TEXT(".json"))))
+	{
+		UE_LOG(LogHynmersMovementBenchmark, Error, TEXT("Could not write the report to %s"), *OutPath);
+		return 1;
+	}
+	UE_LOG(LogHynmersMovementBenchmark, Display, TEXT("Report written to %s.csv and %s.json"), *OutPath, *OutPath);
+
+	return 0;
+}
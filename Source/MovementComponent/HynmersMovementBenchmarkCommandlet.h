@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HynmersMovementBenchmarkCommandlet.generated.h"
+
+/*
+ * Headless movement benchmark over a procedural world with a floor, stairs, ramps, a cube planet and a sphere planet.
+ * -run=HynmersMovementBenchmark -nullrhi [-Characters=256] [-Frames=600] [-Warmup=60] [-NoManager] [-DistanceField] [-Out=<path without extension>]
+ * -DistanceField bakes a static distance field of the world for the floor queries.
+ * The HynmersMovementCore kernels alone are timed by the standalone HynmersMovementMicro program.
+ */
+UCLASS()
+class UHynmersMovementBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UHynmersMovementBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -1,6 +1,16 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "HynmersMovementComponent.h"
+#include "HynmersGravityManager.h"
+#include "HynmersMovementManager.h"
+#include "HynmersCharacter.h"
+#include "HynmersNetQuantize.h"
+#include "HynmersMovementTrace.h"
+#include "HynmersMovementStats.h"
+#include "HynmersTangentMath.h"
+#include "HynmersMovementCoreRecorder.h"
+#include "HynmersStaticDistanceField.h"
+#include "HynmersWaterBody.h"
 
 #include "GameFramework/GameStateBase.h"
 #include "EngineStats.h"
@@ -12,26 +22,40 @@
 #include "Components/SkeletalMeshComponent.h"
 #include "DrawDebugHelpers.h"
 #include "Engine/NetworkObjectList.h"
-#include "Kismet/KismetMathLibrary.h"
 #include "Components/BrushComponent.h"
 
-DECLARE_CYCLE_STAT(TEXT("Char Tick"), STAT_CharacterMovementTick, STATGROUP_Character);
-DECLARE_CYCLE_STAT(TEXT("Char NonSimulated Time"), STAT_CharacterMovementNonSimulated, STATGROUP_Character);
-DECLARE_CYCLE_STAT(TEXT("Char PerformMovement"), STAT_CharacterMovementPerformMovement, STATGROUP_Character);
-DECLARE_CYCLE_STAT(TEXT("Char RootMotionSource Calculate"), STAT_CharacterMovementRootMotionSourceCalculate, STATGROUP_Character);
-DECLARE_CYCLE_STAT(TEXT("Char RootMotionSource Apply"), STAT_CharacterMovementRootMotionSourceApply, STATGROUP_Character);
-DECLARE_CYCLE_STAT(TEXT("Char Update Acceleration"), STAT_CharUpdateAcceleration, STATGROUP_Character);
-DECLARE_CYCLE_STAT(TEXT("Ch MoveAloar Physics Interation"), STAT_CharPhysicsInteraction, STATGROUP_Character);
-DECLARE_CYCLE_STAT(TEXT("Char PhysWalking"), STAT_CharPhysWalking, STATGROUP_Character);
-DECLARE_CYCLE_STAT(TEXT("Char PhysFalling"), STAT_CharPhysFalling, STATGROUP_Character);
-DECLARE_CYCLE_STAT(TEXT("Char FindFloor"), STAT_CharFindFloor, STATGROUP_Character);
-DECLARE_CYCLE_STAT(TEXT("Char StepUp"), STAT_CharStepUp, STATGROUP_Character);
-DECLARE_CYCLE_STAT(TEXT("Char AdjustFloorHeight"), STAT_CharAdjustFloorHeight, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char Tick"), STAT_CharacterMovementTick, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char NonSimulated Time"), STAT_CharacterMovementNonSimulated, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char Simulated Time"), STAT_CharacterMovementSimulated, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char PerformMovement"), STAT_CharacterMovementPerformMovement, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char RootMotionSource Calculate"), STAT_CharacterMovementRootMotionSourceCalculate, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char RootMotionSource Apply"), STAT_CharacterMovementRootMotionSourceApply, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char Update Acceleration"), STAT_CharUpdateAcceleration, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Ch MoveAloar Physics Interation"), STAT_CharPhysicsInteraction, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char PhysWalking"), STAT_CharPhysWalking, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char PhysFalling"), STAT_CharPhysFalling, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char FindFloor"), STAT_CharFindFloor, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char StepUp"), STAT_CharStepUp, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char AdjustFloorHeight"), STAT_CharAdjustFloorHeight, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char PhysSwimming"), STAT_CharPhysSwimming, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char StartSwimming"), STAT_CharStartSwimming, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char SlideAlongSurface"), STAT_CharSlideAlongSurface, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char TwoWallAdjust"), STAT_CharTwoWallAdjust, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char ComputePerchResult"), STAT_CharComputePerchResult, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char GetLedgeMove"), STAT_CharGetLedgeMove, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char ImmersionDepth"), STAT_CharImmersionDepth, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char UpdateOrientation"), STAT_CharUpdateOrientation, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Char UpdateGravity"), STAT_CharUpdateGravity, STATGROUP_HynmersMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sleeping characters"), STAT_HynmersSleepingCharacters, STATGROUP_HynmersMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Awake characters"), STAT_HynmersAwakeCharacters, STATGROUP_HynmersMovement);
 
 const float MAX_STEP_SIDE_Z = 0.08f;	// maximum z value for the normal on the vertical side of steps
 const float SWIMBOBSPEED = -80.f;
 const float VERTICAL_SLOPE_NORMAL_Z = 0.001f; // Slope is vertical if Abs(Normal.Z) <= this threshold. Accounts for precision problems that sometimes angle normals slightly off horizontal for vertical surface.
 
+int32 UHynmersMovementComponent::NumSleepingCharacters = 0;
+int32 UHynmersMovementComponent::NumAwakeCharacters = 0;
+
 UHynmersMovementComponent::UHynmersMovementComponent() 
 {
 	PostPhysicsTickFunction.bCanEverTick = true;
@@ -165,6 +189,9 @@ UHynmersMovementComponent::UHynmersMovementComponent()
 	GroupsToAvoid.Packed = 0xFFFFFFFF;
 	GroupsToIgnore.Packed = 0;
 	AvoidanceConsiderationRadius = 500.0f;
+	AvoidanceCorrection = FVector::ZeroVector;
+	bHasAvoidanceCorrection = false;
+	bManagedByMovementManager = false;
 
 	OldBaseQuat = FQuat::Identity;
 	OldBaseLocation = FVector::ZeroVector;
@@ -174,28 +201,102 @@ UHynmersMovementComponent::UHynmersMovementComponent()
 	NavMeshProjectionHeightScaleUp = 0.67f;
 	NavMeshProjectionHeightScaleDown = 1.0f;
 	NavWalkingFloorDistTolerance = 10.0f;
+
+	bUseGravityField = true;
+	GravityDirection = FVector(0.f, 0.f, -1.f);
+	GravityMagnitude = 0.f;
+	bHasFieldGravity = false;
+
+	bUseMovementManager = false;
+	PendingInputVector = FVector::ZeroVector;
+	bMovementTickPrepared = false;
+	bHasPrefetchedFloor = false;
+	bFloorRebased = false;
+	bUseFloorCache = true;
+	bEnableSleeping = true;
+	bIsSleeping = false;
+	SleepGravityDirection = FVector::ZeroVector;
+	bSleepHasFieldGravity = false;
+	IdleTime = 0.f;
+	MovementTickTier = EHynmersMovementTickTier::Full;
+	AccumulatedDeltaTime = 0.f;
+	ExtrapolatedMeshOffset = FVector::ZeroVector;
+	bUseFixedTimestep = false;
+	bUseAsyncFloorPrediction = false;
+	bUseStaticDistanceField = true;
+	FixedTimeAccumulator = 0.f;
+	NumPendingFixedSteps = 0;
+	bHasPreviousSimState = false;
+	ProxyMeshOffset = FVector::ZeroVector;
+	ProxyRotationOffset = FQuat::Identity;
+	ProxyTimeSinceUpdate = 0.f;
 }
 
-void UHynmersMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+void UHynmersMovementComponent::BeginPlay()
 {
-	SCOPED_NAMED_EVENT(UCharacterMovementComponent_TickComponent, FColor::Yellow);
-	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementTick);
+	Super::BeginPlay();
 
-	const FVector InputVector = ConsumeInputVector();
-	UpVector = UpdatedComponent->GetUpVector();
+	++NumAwakeCharacters;
+	INC_DWORD_STAT(STAT_HynmersAwakeCharacters);
 
-	if (FVector::CrossProduct(CurrentFloor.HitResult.ImpactNormal, UpVector).Size() >= KINDA_SMALL_NUMBER) {
-		FVector AxisToRotate = FVector::CrossProduct(UpVector , CurrentFloor.HitResult.ImpactNormal);
-		FQuat DeltaRotation(UKismetMathLibrary::RotatorFromAxisAndAngle(AxisToRotate, FMath::Min(AngularVelocity*DeltaTime, UKismetMathLibrary::DegAsin(AxisToRotate.Size()))));
+	if (UpdatedPrimitive)
+	{
+		UpdatedPrimitive->OnComponentBeginOverlap.AddDynamic(this, &UHynmersMovementComponent::OnUpdatedComponentBeginOverlap);
+	}
 
-		UpdatedComponent->AddWorldRotation(DeltaRotation);
+	if (bUseMovementManager)
+	{
+		if (AHynmersMovementManager* MovementManager = AHynmersMovementManager::FindOrSpawn(GetWorld()))
+		{
+			MovementManager->RegisterComponent(this);
+		}
 	}
+}
 
-	UpVector = UpdatedComponent->GetUpVector();
-	ForwardVector = UpdatedComponent->GetForwardVector();
-	RightVector = UpdatedComponent->GetRightVector();
+void UHynmersMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bIsSleeping)
+	{
+		--NumSleepingCharacters;
+		DEC_DWORD_STAT(STAT_HynmersSleepingCharacters);
+		bIsSleeping = false;
+	}
+	else
+	{
+		--NumAwakeCharacters;
+		DEC_DWORD_STAT(STAT_HynmersAwakeCharacters);
+	}
+
+	if (UpdatedPrimitive)
+	{
+		UpdatedPrimitive->OnComponentBeginOverlap.RemoveDynamic(this, &UHynmersMovementComponent::OnUpdatedComponentBeginOverlap);
+	}
+
+	if (AHynmersMovementManager* MovementManager = AHynmersMovementManager::Find(GetWorld()))
+	{
+		MovementManager->UnregisterComponent(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UHynmersMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	SCOPED_NAMED_EVENT(UCharacterMovementComponent_TickComponent, FColor::Yellow);
+	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementTick);
+
+	if (!bMovementTickPrepared)
+	{
+		if (!ConsumeTickBudget(DeltaTime))
+		{
+			return;
+		}
+		PrepareMovementTick(DeltaTime);
+		PendingInputVector = ConstrainInputAcceleration(PendingInputVector);
+	}
+	bMovementTickPrepared = false;
 
-	if (!HasValidData() || ShouldSkipUpdate(DeltaTime))
+	if (bIsSleeping || !HasValidData() || ShouldSkipUpdate(DeltaTime))
 	{
 		return;
 	}
@@ -224,23 +325,63 @@ void UHynmersMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 				CharacterOwner->CheckJumpInput(DeltaTime);
 
 				// apply input to acceleration
-				Acceleration = ScaleInputAcceleration(ConstrainInputAcceleration(InputVector));
+				Acceleration = ScaleInputAcceleration(PendingInputVector);
 
 				AnalogInputModifier = ComputeAnalogInputModifier();
 			}
 
-			if (CharacterOwner->Role == ROLE_Authority)
+			// Autonomous proxies predict the move locally and send it to the server
+			const bool bIsClient = (CharacterOwner->Role == ROLE_AutonomousProxy && IsNetMode(NM_Client));
+			if (CharacterOwner->Role == ROLE_Authority || bIsClient)
 			{
-				PerformMovement(DeltaTime);
+				// Replay the moves still pending after a server correction before predicting new ones
+				if (bIsClient)
+				{
+					ClientUpdatePositionAfterServerUpdate();
+				}
+
+				const int32 NumSteps = FMath::Max(NumPendingFixedSteps, 1);
+				const float StepTime = NumPendingFixedSteps > 0 ? FixedTimestep : DeltaTime;
+				for (int32 Step = 0; Step < NumSteps; ++Step)
+				{
+					PreviousSimLocation = UpdatedComponent->GetComponentLocation();
+					PreviousSimQuat = UpdatedComponent->GetComponentQuat();
+
+					if (bIsClient)
+					{
+						ReplicateMoveToServer(StepTime, Acceleration);
+					}
+					else
+					{
+						PerformMovement(StepTime);
+					}
+				}
+
+				if (NumPendingFixedSteps > 0)
+				{
+					bHasPreviousSimState = true;
+					ApplyFixedStepInterpolation();
+				}
+
+				if (bUseAsyncFloorPrediction)
+				{
+					RequestFloorPrediction(StepTime);
+				}
 			}
 		}
 
 	}
 
+	else if (CharacterOwner->Role == ROLE_SimulatedProxy)
+	{
+		SimulatedProxyTick(DeltaTime);
+	}
+
 	if (bUseRVOAvoidance)
 	{
 		UpdateDefaultAvoidance();
 	}
+	bHasAvoidanceCorrection = false;
 
 	if (bEnablePhysicsInteraction)
 	{
@@ -248,6 +389,164 @@ void UHynmersMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 		ApplyDownwardForce(DeltaTime);
 		ApplyRepulsionForce(DeltaTime);
 	}
+
+	if (bEnableSleeping && CanSleep())
+	{
+		IdleTime += DeltaTime;
+		if (IdleTime >= SleepDelay)
+		{
+			GoToSleep();
+		}
+	}
+	else
+	{
+		IdleTime = 0.f;
+	}
+}
+
+void UHynmersMovementComponent::PrepareMovementTick(float DeltaTime)
+{
+	PendingInputVector = ConsumeInputVector();
+
+	if (!UpdatedComponent)
+	{
+		return;
+	}
+
+	if (bIsSleeping)
+	{
+		if (!ShouldWakeUp())
+		{
+			return;
+		}
+		WakeUp();
+	}
+
+	UpdateGravity();
+
+	UpVector = UpdatedComponent->GetUpVector();
+	ForwardVector = UpdatedComponent->GetForwardVector();
+	RightVector = UpdatedComponent->GetRightVector();
+}
+
+void UHynmersMovementComponent::UpdateOrientation(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharUpdateOrientation);
+
+	if (IsMovingOnGround() && CurrentFloor.IsWalkableFloor())
+	{
+		OrientationSolver.AddFloorNormal(CurrentFloor.HitResult.ImpactNormal);
+	}
+	else
+	{
+		OrientationSolver.Reset();
+	}
+
+	const FQuat CurrentQuat = UpdatedComponent->GetComponentQuat();
+	const FVector CurrentUpVector = CurrentQuat.GetUpVector();
+	const FQuat DeltaRotation = FHynmersOrientationSolver::ComputeDeltaRotation(CurrentUpVector, GetTargetUpVector(), FMath::DegreesToRadians(AngularVelocity * DeltaTime));
+	if (!DeltaRotation.Equals(FQuat::Identity, KINDA_SMALL_NUMBER))
+	{
+		// Part of the scoped move, the transform and overlaps are updated once with the translation
+		MoveUpdatedComponent(FVector::ZeroVector, DeltaRotation * CurrentQuat, false);
+	}
+
+	const FQuat NewQuat = UpdatedComponent->GetComponentQuat();
+	UpVector = NewQuat.GetUpVector();
+	ForwardVector = NewQuat.GetForwardVector();
+	RightVector = NewQuat.GetRightVector();
+}
+
+void UHynmersMovementComponent::UpdateBasedMovement(float DeltaSeconds)
+{
+	bFloorRebased = false;
+
+	if (!HasValidData())
+	{
+		return;
+	}
+
+	const UPrimitiveComponent* MovementBase = CharacterOwner->GetMovementBase();
+	if (!MovementBaseUtility::UseRelativeLocation(MovementBase))
+	{
+		return;
+	}
+
+	if (!IsValid(MovementBase) || !IsValid(MovementBase->GetOwner()))
+	{
+		SetBase(NULL);
+		return;
+	}
+
+	// Ignore collision with bases during these movements.
+	TGuardValue<EMoveComponentFlags> ScopedFlagRestore(MoveComponentFlags, MoveComponentFlags | MOVECOMP_IgnoreBases);
+
+	FQuat NewBaseQuat;
+	FVector NewBaseLocation;
+	if (!MovementBaseUtility::GetMovementBaseTransform(MovementBase, CharacterOwner->GetBasedMovement().BoneName, NewBaseLocation, NewBaseQuat))
+	{
+		return;
+	}
+
+	const bool bRotationChanged = !OldBaseQuat.Equals(NewBaseQuat, 1e-8f);
+	if (!bRotationChanged && OldBaseLocation == NewBaseLocation)
+	{
+		return;
+	}
+
+	const FQuat DeltaQuat = bRotationChanged ? NewBaseQuat * OldBaseQuat.Inverse() : FQuat::Identity;
+	const FTransform OldBaseTransform(OldBaseQuat, OldBaseLocation);
+	const FTransform NewBaseTransform(NewBaseQuat, NewBaseLocation);
+
+	// The whole rotation of the base, not only its yaw, so characters on a tumbling platform or a spinning planet stay aligned with it
+	const FQuat OldQuat = UpdatedComponent->GetComponentQuat();
+	const FQuat NewQuat = (bRotationChanged && !bIgnoreBaseRotation) ? (DeltaQuat * OldQuat).GetNormalized() : OldQuat;
+
+	// Move the feet with the base, not the capsule center
+	const float HalfHeight = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FVector OldFeet = OldLocation - OldQuat.GetUpVector() * HalfHeight;
+	const FVector NewFeet = NewBaseTransform.TransformPosition(OldBaseTransform.InverseTransformPosition(OldFeet));
+	const FVector DeltaPosition = ConstrainDirectionToPlane(NewFeet + NewQuat.GetUpVector() * HalfHeight - OldLocation);
+
+	if (bFastAttachedMove)
+	{
+		// we're trusting no other obstacle can prevent the move here
+		UpdatedComponent->SetWorldLocationAndRotation(OldLocation + DeltaPosition, NewQuat, false);
+	}
+	else
+	{
+		FHitResult MoveOnBaseHit(1.f);
+		MoveUpdatedComponent(DeltaPosition, NewQuat, true, &MoveOnBaseHit);
+		if (!(UpdatedComponent->GetComponentLocation() - (OldLocation + DeltaPosition)).IsNearlyZero())
+		{
+			OnUnableToFollowBaseMove(DeltaPosition, OldLocation, MoveOnBaseHit);
+		}
+	}
+
+	const FQuat FinalQuat = UpdatedComponent->GetComponentQuat();
+	UpVector = FinalQuat.GetUpVector();
+	ForwardVector = FinalQuat.GetForwardVector();
+	RightVector = FinalQuat.GetRightVector();
+
+	// Carried rigidly: the floor moved with the base, no need to sweep for it again
+	const bool bFollowedBase = (UpdatedComponent->GetComponentLocation() - (OldLocation + DeltaPosition)).IsNearlyZero() && FinalQuat.Equals(NewQuat, 1e-6f);
+	if (bFollowedBase && IsMovingOnGround() && CurrentFloor.IsWalkableFloor() && CurrentFloor.HitResult.Component.Get() == MovementBase)
+	{
+		FHitResult& FloorHit = CurrentFloor.HitResult;
+		FloorHit.Location = NewBaseTransform.TransformPosition(OldBaseTransform.InverseTransformPosition(FloorHit.Location));
+		FloorHit.ImpactPoint = NewBaseTransform.TransformPosition(OldBaseTransform.InverseTransformPosition(FloorHit.ImpactPoint));
+		FloorHit.TraceStart = NewBaseTransform.TransformPosition(OldBaseTransform.InverseTransformPosition(FloorHit.TraceStart));
+		FloorHit.TraceEnd = NewBaseTransform.TransformPosition(OldBaseTransform.InverseTransformPosition(FloorHit.TraceEnd));
+		FloorHit.Normal = DeltaQuat.RotateVector(FloorHit.Normal);
+		FloorHit.ImpactNormal = DeltaQuat.RotateVector(FloorHit.ImpactNormal);
+		bFloorRebased = !bIgnoreBaseRotation || !bRotationChanged;
+	}
+
+	if (MovementBase->IsSimulatingPhysics() && CharacterOwner->GetMesh())
+	{
+		CharacterOwner->GetMesh()->ApplyDeltaToAllPhysicsTransforms(DeltaPosition, DeltaQuat);
+	}
 }
 
 void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
@@ -262,10 +561,9 @@ void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
 	// no movement if we can't move, or if currently doing physical simulation on UpdatedComponent
 	if (MovementMode == MOVE_None || UpdatedComponent->Mobility != EComponentMobility::Movable || UpdatedComponent->IsSimulatingPhysics())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("MovementMode == MOVE_None || UpdatedComponent->Mobility != EComponentMobility::Movable || UpdatedComponent->IsSimulatingPhysics()"))
+		MovementTrace.Record(EHynmersTraceEvent::MoveSkipped, MovementMode, UpdatedComponent->GetComponentLocation(), DeltaSeconds);
 		if (!CharacterOwner->bClientUpdating && CharacterOwner->IsPlayingRootMotion() && CharacterOwner->GetMesh() && !CharacterOwner->bServerMoveIgnoreRootMotion)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("!CharacterOwner->bClientUpdating && CharacterOwner->IsPlayingRootMotion() && CharacterOwner->GetMesh() && !CharacterOwner->bServerMoveIgnoreRootMotion"))
 			// Consume root motion
 			TickCharacterPose(DeltaSeconds);
 			RootMotionParams.Clear();
@@ -282,8 +580,6 @@ void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
 	// Update saved LastPreAdditiveVelocity with any external changes to character Velocity that happened since last update.
 	if (CurrentRootMotion.HasAdditiveVelocity())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("CurrentRootMotion.HasAdditiveVelocity()"))
-
 		const FVector Adjustment = (Velocity - LastUpdateVelocity);
 		CurrentRootMotion.LastPreAdditiveVelocity += Adjustment;
 
@@ -307,7 +603,9 @@ void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
 	{
 		FScopedMovementUpdate ScopedMovementUpdate(UpdatedComponent, bEnableScopedMovementUpdates ? EScopedUpdate::DeferredUpdates : EScopedUpdate::ImmediateUpdates);
 
-		//MaybeUpdateBasedMovement(DeltaSeconds);
+		MaybeUpdateBasedMovement(DeltaSeconds);
+
+		UpdateOrientation(DeltaSeconds);
 
 		// Clean up invalid RootMotion Sources.
 		// This includes RootMotion sources that ended naturally.
@@ -316,8 +614,6 @@ void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
 		const bool bHasRootMotionSources = HasRootMotionSources();
 		if (bHasRootMotionSources && !CharacterOwner->bClientUpdating && !CharacterOwner->bServerMoveIgnoreRootMotion)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("bHasRootMotionSources && !CharacterOwner->bClientUpdating && !CharacterOwner->bServerMoveIgnoreRootMotion"))
-
 			SCOPE_CYCLE_COUNTER(STAT_CharacterMovementRootMotionSourceCalculate);
 
 			const FVector VelocityBeforeCleanup = Velocity;
@@ -365,8 +661,6 @@ void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
 		// Update saved LastPreAdditiveVelocity with any external changes to character Velocity that happened due to ApplyAccumulatedForces/HandlePendingLaunch
 		if (CurrentRootMotion.HasAdditiveVelocity())
 		{
-			UE_LOG(LogTemp, Warning, TEXT("CurrentRootMotion.HasAdditiveVelocity()"))
-
 			const FVector Adjustment = (Velocity - OldVelocity);
 			CurrentRootMotion.LastPreAdditiveVelocity += Adjustment;
 
@@ -386,28 +680,20 @@ void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
 		// Prepare Root Motion (generate/accumulate from root motion sources to be used later)
 		if (bHasRootMotionSources && !CharacterOwner->bClientUpdating && !CharacterOwner->bServerMoveIgnoreRootMotion)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("bHasRootMotionSources && !CharacterOwner->bClientUpdating && !CharacterOwner->bServerMoveIgnoreRootMotion"))
-
 			// Animation root motion - If using animation RootMotion, tick animations before running physics.
 			if (CharacterOwner->IsPlayingRootMotion() && CharacterOwner->GetMesh())
 			{
-				UE_LOG(LogTemp, Warning, TEXT("CharacterOwner->IsPlayingRootMotion() && CharacterOwner->GetMesh()"))
-
 				TickCharacterPose(DeltaSeconds);
 
 				// Make sure animation didn't trigger an event that destroyed us
 				if (!HasValidData())
 				{
-					UE_LOG(LogTemp, Warning, TEXT("!HasValidData()"))
-
 					return;
 				}
 
 				// For local human clients, save off root motion data so it can be used by movement networking code.
 				if (CharacterOwner->IsLocallyControlled() && (CharacterOwner->Role == ROLE_AutonomousProxy) && CharacterOwner->IsPlayingNetworkedRootMotionMontage())
 				{
-					UE_LOG(LogTemp, Warning, TEXT("CharacterOwner->IsLocallyControlled() && (CharacterOwner->Role == ROLE_AutonomousProxy) && CharacterOwner->IsPlayingNetworkedRootMotionMontage()"))
-
 					CharacterOwner->ClientRootMotionParams = RootMotionParams;
 				}
 			}
@@ -421,8 +707,6 @@ void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
 			// For local human clients, save off root motion data so it can be used by movement networking code.
 			if (CharacterOwner->IsLocallyControlled() && (CharacterOwner->Role == ROLE_AutonomousProxy))
 			{
-				UE_LOG(LogTemp, Warning, TEXT("CharacterOwner->IsLocallyControlled() && (CharacterOwner->Role == ROLE_AutonomousProxy)"))
-
 				CharacterOwner->SavedRootMotion = CurrentRootMotion;
 			}
 		}
@@ -430,19 +714,13 @@ void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
 		// Apply Root Motion to Velocity
 		if (CurrentRootMotion.HasOverrideVelocity() || HasAnimRootMotion())
 		{
-			UE_LOG(LogTemp, Warning, TEXT("CurrentRootMotion.HasOverrideVelocity() || HasAnimRootMotion()"))
-
 			// Animation root motion overrides Velocity and currently doesn't allow any other root motion sources
 			if (HasAnimRootMotion())
 			{
-				UE_LOG(LogTemp, Warning, TEXT("HasAnimRootMotion()"))
-
 				// Convert to world space (animation root motion is always local)
 				USkeletalMeshComponent * SkelMeshComp = CharacterOwner->GetMesh();
 				if (SkelMeshComp)
 				{
-					UE_LOG(LogTemp, Warning, TEXT("SkelMeshComp"))
-
 					// Convert Local Space Root Motion to world space. Do it right before used by physics to make sure we use up to date transforms, as translation is relative to rotation.
 					RootMotionParams.Set(SkelMeshComp->ConvertLocalRootMotionToWorld(RootMotionParams.GetRootMotionTransform()));
 				}
@@ -454,12 +732,7 @@ void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
 					Velocity = ConstrainAnimRootMotionVelocity(AnimRootMotionVelocity, Velocity);
 				}
 
-				UE_LOG(LogTemp, Warning, TEXT("PerformMovement WorldSpaceRootMotion Translation: %s, Rotation: %s, Actor Facing: %s, Velocity: %s")
-					, *RootMotionParams.GetRootMotionTransform().GetTranslation().ToCompactString()
-					, *RootMotionParams.GetRootMotionTransform().GetRotation().Rotator().ToCompactString()
-					, *CharacterOwner->GetActorForwardVector().ToCompactString()
-					, *Velocity.ToCompactString()
-				);
+				MovementTrace.Record(EHynmersTraceEvent::RootMotion, MovementMode, RootMotionParams.GetRootMotionTransform().GetTranslation(), Velocity.Size());
 			}
 			else
 			{
@@ -522,42 +795,17 @@ void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
 		// Apply Root Motion rotation after movement is complete.
 		if (HasAnimRootMotion())
 		{
-			UE_LOG(LogTemp, Warning, TEXT("HasAnimRootMotion"))
-
 			const FQuat OldActorRotationQuat = UpdatedComponent->GetComponentQuat();
 			const FQuat RootMotionRotationQuat = RootMotionParams.GetRootMotionTransform().GetRotation();
 			if (!RootMotionRotationQuat.IsIdentity())
 			{
-				UE_LOG(LogTemp, Warning, TEXT("!RootMotionRotationQuat.IsIdentity()"))
-
 				const FQuat NewActorRotationQuat = RootMotionRotationQuat * OldActorRotationQuat;
 				MoveUpdatedComponent(FVector::ZeroVector, NewActorRotationQuat, true);
 			}
 
-#if !(UE_BUILD_SHIPPING)
-			// debug
-			if (true)
-			{
-				const FRotator OldActorRotation = OldActorRotationQuat.Rotator();
-				const FVector ResultingLocation = UpdatedComponent->GetComponentLocation();
-				const FRotator ResultingRotation = UpdatedComponent->GetComponentRotation();
-
-				// Show current position
-				DrawDebugCoordinateSystem(GetWorld(), CharacterOwner->GetMesh()->GetComponentLocation() + FVector(0, 0, 1), ResultingRotation, 50.f, false);
-
-				// Show resulting delta move.
-				DrawDebugLine(GetWorld(), OldLocation, ResultingLocation, FColor::Red, true, 10.f);
-
-				// Log details.
-				UE_LOG(LogRootMotion, Warning, TEXT("PerformMovement Resulting DeltaMove Translation: %s, Rotation: %s, MovementBase: %s"),
-					*(ResultingLocation - OldLocation).ToCompactString(), *(ResultingRotation - OldActorRotation).GetNormalized().ToCompactString(), *GetNameSafe(CharacterOwner->GetMovementBase()));
-
-				const FVector RMTranslation = RootMotionParams.GetRootMotionTransform().GetTranslation();
-				const FRotator RMRotation = RootMotionParams.GetRootMotionTransform().GetRotation().Rotator();
-				UE_LOG(LogRootMotion, Warning, TEXT("PerformMovement Resulting DeltaError Translation: %s, Rotation: %s"),
-					*(ResultingLocation - OldLocation - RMTranslation).ToCompactString(), *(ResultingRotation - OldActorRotation - RMRotation).GetNormalized().ToCompactString());
-			}
-#endif // !(UE_BUILD_SHIPPING)
+			// Error between the resulting move and the root motion translation
+			const FVector RootMotionError = UpdatedComponent->GetComponentLocation() - OldLocation - RootMotionParams.GetRootMotionTransform().GetTranslation();
+			MovementTrace.Record(EHynmersTraceEvent::RootMotion, MovementMode, RootMotionError, RootMotionRotationQuat.GetAngle(), 1);
 
 			// Root Motion has been used, clear
 			RootMotionParams.Clear();
@@ -586,18 +834,12 @@ void UHynmersMovementComponent::PerformMovement(float DeltaSeconds)
 			UNetDriver* NetDriver = MyWorld->GetNetDriver();
 			if (NetDriver && NetDriver->IsServer())
 			{
-				UE_LOG(LogTemp, Warning, TEXT("NetDriver && NetDriver->IsServer()"))
-
 				FNetworkObjectInfo* NetActor = NetDriver->GetNetworkObjectInfo(CharacterOwner);
 
 				if (NetActor && MyWorld->GetTimeSeconds() <= NetActor->NextUpdateTime && NetDriver->IsNetworkActorUpdateFrequencyThrottled(*NetActor))
 				{
-					UE_LOG(LogTemp, Warning, TEXT("NetActor && MyWorld->GetTimeSeconds() <= NetActor->NextUpdateTime"))
-
 					if (ShouldCancelAdaptiveReplication())
 					{
-						UE_LOG(LogTemp, Warning, TEXT("ShouldCancelAdaptiveReplication"))
-
 						NetDriver->CancelAdaptiveReplication(*NetActor);
 					}
 				}
@@ -657,6 +899,8 @@ void UHynmersMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
 	while ((remainingTime >= MIN_TICK_TIME) && (Iterations < MaxSimulationIterations) && CharacterOwner && (CharacterOwner->Controller || bRunPhysicsWithNoController || HasAnimRootMotion() || CurrentRootMotion.HasOverrideVelocity() || (CharacterOwner->Role == ROLE_SimulatedProxy)))
 	{
 		Iterations++;
+		HYNMERS_COUNT(Iterations, STAT_HynmersIterations, MovementMode);
+		INC_DWORD_STAT(STAT_HynmersIterationsWalking);
 		bJustTeleported = false;
 		const float timeTick = GetSimulationTimeStep(remainingTime, Iterations);
 		remainingTime -= timeTick;
@@ -673,7 +917,7 @@ void UHynmersMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
 		// Ensure velocity is horizontal.
 		MaintainHorizontalGroundVelocity();
 		const FVector OldVelocity = Velocity;
-		Acceleration -= (Acceleration | UpVector)*UpVector;
+		Acceleration = HynmersTangentMath::ProjectOnPlane(Acceleration, UpVector);
 
 		// Apply acceleration
 		if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
@@ -735,10 +979,20 @@ void UHynmersMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
 		{
 			CurrentFloor = StepDownResult.FloorResult;
 		}
+		else if (bHasPrefetchedFloor && UpdatedComponent->GetComponentLocation() == PrefetchedFloorLocation && UpdatedComponent->GetUpVector() == PrefetchedFloorUpVector)
+		{
+			// The parallel floor phase already computed the floor here, CurrentFloor holds it.
+			bForceNextFloorCheck = false;
+		}
+		else if (ConsumeFloorPrediction(UpdatedComponent->GetComponentLocation(), CurrentFloor))
+		{
+			// Swept asynchronously last frame at the location we just reached.
+		}
 		else
 		{
 			FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, bZeroDelta, NULL);
 		}
+		bHasPrefetchedFloor = false;
 
 		 //check for ledges here
 		const bool bCheckLedges = !CanWalkOffLedges();
@@ -835,6 +1089,12 @@ void UHynmersMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
 		}
 	}
 
+	if (remainingTime >= MIN_TICK_TIME && Iterations >= MaxSimulationIterations)
+	{
+		HYNMERS_COUNT(IterationCaps, STAT_HynmersIterationCaps, MovementMode);
+		MovementTrace.Record(EHynmersTraceEvent::IterationCap, MovementMode, Velocity, remainingTime, Iterations);
+	}
+
 	if (IsMovingOnGround())
 	{
 		MaintainHorizontalGroundVelocity();
@@ -850,7 +1110,7 @@ void UHynmersMovementComponent::MoveAlongFloor(const FVector & InVelocity, float
 
 	// Move along the current floor
 	// Have to changed  to avoid z clamping. Have to make UpVector Clamping
-	const FVector Delta = (InVelocity - (InVelocity | UpVector)*UpVector) * DeltaSeconds;
+	const FVector Delta = HynmersTangentMath::ProjectOnPlane(InVelocity, UpVector) * DeltaSeconds;
 
 	FHitResult Hit(1.f);
 	FVector RampVector = ComputeGroundMovementDelta(Delta, CurrentFloor.HitResult, CurrentFloor.bLineTrace);
@@ -860,7 +1120,7 @@ void UHynmersMovementComponent::MoveAlongFloor(const FVector & InVelocity, float
 	
 	if (Hit.bStartPenetrating)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("bStartPenetrating = %d"), Hit.bStartPenetrating);
+		MovementTrace.Record(EHynmersTraceEvent::Penetration, MovementMode, Hit.Normal, Hit.PenetrationDepth);
 		// Allow this hit to be used as an impact we can deflect off, otherwise we do nothing the rest of the update and appear to hitch.
 		HandleImpact(Hit);
 		SlideAlongSurface(Delta, 1.f, Hit.Normal, Hit, true);
@@ -895,14 +1155,14 @@ void UHynmersMovementComponent::MoveAlongFloor(const FVector & InVelocity, float
 				const FVector GravDir = -UpVector;
 				if (!StepUp(GravDir, Delta * (1.f - PercentTimeApplied), Hit, OutStepDownResult))
 				{
-					UE_LOG(LogTemp, Log, TEXT("- StepUp (ImpactNormal %s, Normal %s"), *Hit.ImpactNormal.ToString(), *Hit.Normal.ToString());
+					MovementTrace.Record(EHynmersTraceEvent::StepUpRejected, MovementMode, Hit.ImpactNormal);
 					HandleImpact(Hit, LastMoveTimeSlice, RampVector);
 					SlideAlongSurface(Delta, 1.f - PercentTimeApplied, Hit.Normal, Hit, true);
 				}
 				else
 				{
 					// Don't recalculate velocity based on this height adjustment, if considering vertical adjustments.
-					UE_LOG(LogTemp, Log, TEXT("+ StepUp (ImpactNormal %s, Normal %s"), *Hit.ImpactNormal.ToString(), *Hit.Normal.ToString());
+					MovementTrace.Record(EHynmersTraceEvent::StepUpAccepted, MovementMode, Hit.ImpactNormal);
 					bJustTeleported |= !bMaintainHorizontalGroundVelocity;
 				}
 			}
@@ -917,31 +1177,122 @@ void UHynmersMovementComponent::MoveAlongFloor(const FVector & InVelocity, float
 
 FVector UHynmersMovementComponent::GetLedgeMove(const FVector & OldLocation, const FVector & Delta, const FVector & GravDir) const
 {
-	UE_LOG(LogTemp, Warning, TEXT("Own LedgeMovement"))
+	SCOPE_CYCLE_COUNTER(STAT_CharGetLedgeMove);
+
+	MovementTrace.Record(EHynmersTraceEvent::LedgeMove, MovementMode, Delta);
 	if (!HasValidData() || Delta.IsZero())
 	{
 		return FVector::ZeroVector;
 	}
-	FVector SideDir = (Delta | RightVector)*ForwardVector - (Delta | ForwardVector)*RightVector;
+	const FVector SideDir = (Delta | RightVector)*ForwardVector - (Delta | ForwardVector)*RightVector;
 
-	// try left
-	if (CheckLedgeDirection(OldLocation, SideDir, GravDir))
+	// A character held at a ledge asks the same question every tick, possibly with the sides swapped
+	bool bSwapped = false;
+	if (IsLedgeProbeValid(OldLocation) && (SideDir - LedgeProbe.SideDir).SizeSquared() > KINDA_SMALL_NUMBER)
 	{
-		return SideDir;
+		bSwapped = (SideDir + LedgeProbe.SideDir).SizeSquared() <= KINDA_SMALL_NUMBER;
+		if (!bSwapped)
+		{
+			LedgeProbe.Invalidate();
+		}
+	}
+	if (!LedgeProbe.bValid)
+	{
+		ProbeLedges(OldLocation, SideDir, GravDir);
 	}
 
-	// try right
-	SideDir *= -1.f;
-	if (CheckLedgeDirection(OldLocation, SideDir, GravDir))
+	// try left, then right
+	const int32 LeftIndex = bSwapped ? FHynmersLedgeProbe::Right : FHynmersLedgeProbe::Left;
+	if (LedgeProbe.bSideWalkable[LeftIndex])
 	{
 		return SideDir;
 	}
+	if (LedgeProbe.bSideWalkable[1 - LeftIndex])
+	{
+		return -SideDir;
+	}
 
 	return FVector::ZeroVector;
 }
 
+// Stationary and movable components can move or change collision without the character knowing, only hits on static ones are kept
+static bool IsStaticHit(const FHitResult& Hit)
+{
+	const UPrimitiveComponent* Component = Hit.Component.Get();
+	return !Hit.bBlockingHit || (Component && Component->Mobility == EComponentMobility::Static);
+}
+
+bool UHynmersMovementComponent::IsLedgeProbeValid(const FVector& Location) const
+{
+	if (!LedgeProbe.bValid)
+	{
+		return false;
+	}
+
+	const UPrimitiveComponent* Floor = LedgeProbe.Floor.Get();
+	if (!Floor || Floor != CurrentFloor.HitResult.Component.Get() || Floor->Mobility != EComponentMobility::Static
+		|| (UpVector | LedgeProbe.UpVector) < THRESH_NORMALS_ARE_PARALLEL
+		|| (Location - LedgeProbe.Location).SizeSquared() > FMath::Square(FloorCacheTolerance))
+	{
+		LedgeProbe.Invalidate();
+		return false;
+	}
+	return true;
+}
+
+void UHynmersMovementComponent::ProbeLedges(const FVector& OldLocation, const FVector& SideDir, const FVector& GravDir) const
+{
+	FCollisionQueryParams CapsuleParams(SCENE_QUERY_STAT(CheckLedgeDirection), false, CharacterOwner);
+	FCollisionResponseParams ResponseParam;
+	InitCollisionParams(CapsuleParams, ResponseParam);
+	const FCollisionShape CapsuleShape = GetPawnCapsuleCollisionShape(SHRINK_None);
+	const ECollisionChannel CollisionChannel = UpdatedComponent->GetCollisionObjectType();
+	// The capsule is swept as it stands, not upright in world space
+	const FQuat CapsuleQuat = UpdatedComponent->GetComponentQuat();
+	const FVector SideSteps[2] = { SideDir, -SideDir };
+	const FVector DownDelta = GravDir * (MaxStepHeight + LedgeCheckThreshold);
+
+	// The perch test stays valid on the same floor
+	if (LedgeProbe.Floor != CurrentFloor.HitResult.Component || (UpVector | LedgeProbe.UpVector) < THRESH_NORMALS_ARE_PARALLEL)
+	{
+		LedgeProbe.bPerchValid = false;
+	}
+	LedgeProbe.Location = OldLocation;
+	LedgeProbe.SideDir = SideDir;
+	LedgeProbe.UpVector = UpVector;
+	LedgeProbe.Floor = CurrentFloor.HitResult.Component;
+
+	// Side steps of both sides first, then the down sweeps of the free ones
+	bool bSideBlocked[2];
+	for (int32 Side = 0; Side < 2; ++Side)
+	{
+		FHitResult& Result = LedgeProbe.SideHits[Side];
+		Result = FHitResult(1.f);
+		HYNMERS_COUNT(Sweeps, STAT_HynmersSweeps, MovementMode);
+		GetWorld()->SweepSingleByChannel(Result, OldLocation, OldLocation + SideSteps[Side], CapsuleQuat, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
+		bSideBlocked[Side] = Result.bBlockingHit;
+	}
+
+	for (int32 Side = 0; Side < 2; ++Side)
+	{
+		FHitResult& Result = LedgeProbe.SideHits[Side];
+		if (!bSideBlocked[Side])
+		{
+			const FVector SideDest = OldLocation + SideSteps[Side];
+			HYNMERS_COUNT(Sweeps, STAT_HynmersSweeps, MovementMode);
+			GetWorld()->SweepSingleByChannel(Result, SideDest, SideDest + DownDelta, CapsuleQuat, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
+		}
+		LedgeProbe.bSideWalkable[Side] = Result.Time < 1.f && IsWalkable(Result);
+	}
+
+	const UPrimitiveComponent* Floor = LedgeProbe.Floor.Get();
+	LedgeProbe.bValid = Floor && Floor->Mobility == EComponentMobility::Static && IsStaticHit(LedgeProbe.SideHits[0]) && IsStaticHit(LedgeProbe.SideHits[1]);
+}
+
 bool UHynmersMovementComponent::ComputePerchResult(const float TestRadius, const FHitResult & InHit, const float InMaxFloorDist, FFindFloorResult & OutPerchFloorResult) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_CharComputePerchResult);
+
 	if (InMaxFloorDist <= 0.f)
 	{
 		return 0.f;
@@ -952,76 +1303,157 @@ bool UHynmersMovementComponent::ComputePerchResult(const float TestRadius, const
 	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
 
 	const float InHitAboveBase = FMath::Max(0.f, (InHit.ImpactPoint | UpVector)- ((InHit.Location | UpVector) - PawnHalfHeight));
+
+	// Perched at the same ledge of the same static floor as last time
+	const UPrimitiveComponent* Floor = InHit.Component.Get();
+	const bool bStaticFloor = Floor && Floor->Mobility == EComponentMobility::Static;
+	const bool bSameFloor = bStaticFloor && Floor == LedgeProbe.Floor.Get() && (UpVector | LedgeProbe.UpVector) >= THRESH_NORMALS_ARE_PARALLEL;
+	if (bSameFloor && LedgeProbe.bPerchValid && LedgeProbe.PerchRadius == TestRadius && LedgeProbe.PerchMaxFloorDist == InMaxFloorDist
+		&& (InHit.Location - LedgeProbe.PerchLocation).SizeSquared() <= FMath::Square(FloorCacheTolerance))
+	{
+		OutPerchFloorResult = LedgeProbe.PerchResult;
+		return LedgeProbe.bPerchWalkable;
+	}
+
 	const float PerchLineDist = FMath::Max(0.f, InMaxFloorDist - InHitAboveBase);
 	const float PerchSweepDist = FMath::Max(0.f, InMaxFloorDist);
 
 	const float ActualSweepDist = PerchSweepDist + PawnRadius;
 	ComputeFloorDist(InHit.Location, PerchLineDist, ActualSweepDist, OutPerchFloorResult, TestRadius);
 
-	if (!OutPerchFloorResult.IsWalkableFloor())
-	{
-		return false;
-	}
-	else if (InHitAboveBase + OutPerchFloorResult.FloorDist > InMaxFloorDist)
+	bool bWalkable = OutPerchFloorResult.IsWalkableFloor();
+	if (bWalkable && InHitAboveBase + OutPerchFloorResult.FloorDist > InMaxFloorDist)
 	{
 		// Hit something past max distance
 		OutPerchFloorResult.bWalkableFloor = false;
-		return false;
+		bWalkable = false;
 	}
 
-	return true;
+	// Perch tests on a static floor are kept with the ledge probe of that floor, as long as they only hit static components too
+	if (!bStaticFloor || !IsStaticHit(OutPerchFloorResult.HitResult))
+	{
+		LedgeProbe.bPerchValid = false;
+	}
+	else
+	{
+		if (!bSameFloor)
+		{
+			LedgeProbe.Invalidate();
+			LedgeProbe.Floor = InHit.Component;
+			LedgeProbe.UpVector = UpVector;
+		}
+		LedgeProbe.PerchLocation = InHit.Location;
+		LedgeProbe.PerchRadius = TestRadius;
+		LedgeProbe.PerchMaxFloorDist = InMaxFloorDist;
+		LedgeProbe.PerchResult = OutPerchFloorResult;
+		LedgeProbe.bPerchWalkable = bWalkable;
+		LedgeProbe.bPerchValid = true;
+	}
+
+	return bWalkable;
 }
 
 FVector UHynmersMovementComponent::ConstrainInputAcceleration(const FVector & InputAcceleration) const
 {
 	if ((InputAcceleration | UpVector) != 0.f && (IsMovingOnGround() || IsFalling()))
 	{
-		return InputAcceleration - (InputAcceleration | UpVector)*UpVector;
+		return HynmersTangentMath::ProjectOnPlane(InputAcceleration, UpVector);
 	}
 	return InputAcceleration;
 }
 
-void UHynmersMovementComponent::MaintainHorizontalGroundVelocity()
+void UHynmersMovementComponent::RequestDirectMove(const FVector& MoveVelocity, bool bForceMaxSpeed)
 {
-	if ((Velocity | UpVector) != 0.f && bMaintainHorizontalGroundVelocity)
+	if (MoveVelocity.SizeSquared() < KINDA_SMALL_NUMBER)
 	{
-		// Ramp movement already maintained the velocity, so we just want to remove the vertical component.
-		Velocity -= (Velocity | UpVector)*UpVector;
-
+		return;
 	}
+
+	RequestedVelocity = (IsMovingOnGround() || IsFalling()) ? HynmersTangentMath::ProjectOnPlane(MoveVelocity, UpVector) : MoveVelocity;
+	bHasRequestedVelocity = true;
+	bRequestedMoveWithMaxSpeed = bForceMaxSpeed;
+	WakeUp();
 }
 
-FVector UHynmersMovementComponent::ComputeGroundMovementDelta(const FVector & Delta, const FHitResult & RampHit, const bool bHitFromLineTrace) const
+void UHynmersMovementComponent::RequestPathMove(const FVector& MoveInput)
 {
-	const FVector FloorNormal = RampHit.ImpactNormal;
-	const FVector ContactNormal = RampHit.Normal;
-
-	if ((FloorNormal | UpVector) < (1.f - KINDA_SMALL_NUMBER) && (FloorNormal | UpVector) > KINDA_SMALL_NUMBER && (ContactNormal | UpVector) > KINDA_SMALL_NUMBER && !bHitFromLineTrace && IsWalkable(RampHit))
+	if (!MoveInput.IsNearlyZero())
 	{
+		WakeUp();
+	}
 
-		// Compute a vector that moves parallel to the surface, by projecting the horizontal movement direction onto the ramp.
-		const float FloorDotDelta = (FloorNormal | Delta);
-		FVector RampMovement = (Delta | RightVector)*RightVector + (Delta | ForwardVector)*ForwardVector + (-FloorDotDelta / (FloorNormal | UpVector))*UpVector;
+	Super::RequestPathMove(MoveInput);
+}
 
-		if (bMaintainHorizontalGroundVelocity)
-		{
-			return RampMovement;
-		}
-		else
-		{
-			return RampMovement.GetSafeNormal() * Delta.Size();
-		}
+void UHynmersMovementComponent::MaintainHorizontalGroundVelocity()
+{
+	if ((Velocity | UpVector) != 0.f && bMaintainHorizontalGroundVelocity)
+	{
+		// Ramp movement already maintained the velocity, so we just want to remove the vertical component.
+		Velocity = HynmersTangentMath::ProjectOnPlane(Velocity, UpVector);
 	}
-
-	return Delta;
 }
 
-bool UHynmersMovementComponent::SafeMoveUpdatedComponent(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult& OutHit, ETeleportType Teleport)
+void UHynmersMovementComponent::CalcAvoidanceVelocity(float DeltaTime)
 {
-	if (UpdatedComponent == NULL)
+	if (!bManagedByMovementManager)
 	{
-		OutHit.Reset(1.f);
-		return false;
+		Super::CalcAvoidanceVelocity(DeltaTime);
+		return;
+	}
+
+	// Characters the manager did not solve this frame keep their velocity, it never falls back to the world XY avoidance
+	if (!bHasAvoidanceCorrection || !CharacterOwner || CharacterOwner->Role != ROLE_Authority || Velocity.IsZero())
+	{
+		return;
+	}
+
+	const float UpSpeed = Velocity | UpVector;
+	const FVector TangentVelocity = (HynmersTangentMath::ProjectOnPlane(Velocity, UpVector) + AvoidanceCorrection).GetClampedToMaxSize(GetMaxSpeed());
+	Velocity = TangentVelocity + UpVector * UpSpeed;
+
+	// Once per frame, fixed steps would apply it again
+	AvoidanceCorrection = FVector::ZeroVector;
+	bHasAvoidanceCorrection = false;
+}
+
+void UHynmersMovementComponent::UpdateDefaultAvoidance()
+{
+	if (bManagedByMovementManager)
+	{
+		return;
+	}
+
+	Super::UpdateDefaultAvoidance();
+}
+
+FVector UHynmersMovementComponent::ComputeGroundMovementDelta(const FVector & Delta, const FHitResult & RampHit, const bool bHitFromLineTrace) const
+{
+	const bool bWalkableRamp = !bHitFromLineTrace && IsWalkable(RampHit);
+	if (FHynmersCoreRecorder::IsRecording())
+	{
+		FHynmersCoreRecorder::Record(FHynmersCoreCall(EHynmersCoreKernel::ComputeGroundMovementDelta, GetMovementFrame(), Delta, RampHit.ImpactNormal, RampHit.Normal, 0.f, bWalkableRamp, bMaintainHorizontalGroundVelocity));
+	}
+	return HynmersMovementCore::ComputeGroundMovementDelta(GetMovementFrame(), Delta, RampHit.ImpactNormal, RampHit.Normal, bWalkableRamp, bMaintainHorizontalGroundVelocity);
+}
+
+FHynmersMovementFrame UHynmersMovementComponent::GetMovementFrame() const
+{
+	FHynmersMovementFrame Frame;
+	Frame.Up = UpVector;
+	Frame.Forward = ForwardVector;
+	Frame.Right = RightVector;
+	Frame.bConstrainToPlane = bConstrainToPlane;
+	Frame.PlaneConstraintNormal = PlaneConstraintNormal;
+	return Frame;
+}
+
+bool UHynmersMovementComponent::SafeMoveUpdatedComponent(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult& OutHit, ETeleportType Teleport)
+{
+	if (UpdatedComponent == NULL)
+	{
+		OutHit.Reset(1.f);
+		return false;
 	}
 
 	bool bMoveResult = false;
@@ -1278,9 +1710,13 @@ bool UHynmersMovementComponent::StepUp(const FVector & GravDir, const FVector &
 
 bool UHynmersMovementComponent::IsWithinEdgeTolerance(const FVector & CapsuleLocation, const FVector & TestImpactPoint, const float CapsuleRadius) const
 {
-	const float DistFromCenterSq = ((TestImpactPoint - CapsuleLocation) - ((TestImpactPoint - CapsuleLocation)|UpVector)*UpVector).SizeSquared();
-	const float ReducedRadiusSq = FMath::Square(FMath::Max(SWEEP_EDGE_REJECT_DISTANCE + KINDA_SMALL_NUMBER, CapsuleRadius - SWEEP_EDGE_REJECT_DISTANCE));
-	return DistFromCenterSq < ReducedRadiusSq;
+	if (FHynmersCoreRecorder::IsRecording())
+	{
+		FHynmersMovementFrame Frame;
+		Frame.Up = UpVector;
+		FHynmersCoreRecorder::Record(FHynmersCoreCall(EHynmersCoreKernel::IsWithinEdgeTolerance, Frame, CapsuleLocation, TestImpactPoint, FVector::ZeroVector, CapsuleRadius));
+	}
+	return HynmersMovementCore::IsWithinEdgeTolerance(UpVector, CapsuleLocation, TestImpactPoint, CapsuleRadius);
 }
 
 void UHynmersMovementComponent::AdjustFloorHeight()
@@ -1299,7 +1735,7 @@ void UHynmersMovementComponent::AdjustFloorHeight()
 		if (OldFloorDist < MIN_FLOOR_DIST && CurrentFloor.LineDist >= MIN_FLOOR_DIST)
 		{
 			// This would cause us to scale unwalkable walls
-			UE_LOG(LogTemp, Log, TEXT("Adjust floor height aborting due to line trace with small floor distance (line: %.2f, sweep: %.2f)"), CurrentFloor.LineDist, CurrentFloor.FloorDist);
+			MovementTrace.Record(EHynmersTraceEvent::AdjustFloorHeight, MovementMode, FVector(CurrentFloor.LineDist, CurrentFloor.FloorDist, 0.f), 0.f, 1);
 			return;
 		}
 		else
@@ -1317,7 +1753,7 @@ void UHynmersMovementComponent::AdjustFloorHeight()
 		const float AvgFloorDist = (MIN_FLOOR_DIST + MAX_FLOOR_DIST) * 0.5f;
 		const float MoveDist = AvgFloorDist - OldFloorDist;
 		SafeMoveUpdatedComponent(MoveDist*UpVector, UpdatedComponent->GetComponentQuat(), true, AdjustHit);
-		UE_LOG(LogTemp, Log, TEXT("Adjust floor height %.3f (Hit = %d)"), MoveDist, AdjustHit.bBlockingHit);
+		MovementTrace.Record(EHynmersTraceEvent::AdjustFloorHeight, MovementMode, AdjustHit.ImpactNormal, MoveDist, AdjustHit.bBlockingHit ? 2 : 0);
 
 		if (!AdjustHit.IsValidBlockingHit())
 		{
@@ -1362,7 +1798,7 @@ void UHynmersMovementComponent::HandleImpact(const FHitResult & Impact, float Ti
 
 	if (bEnablePhysicsInteraction)
 	{
-		const FVector ForceAccel = Acceleration + (IsFalling() ? GetGravityZ()*UpVector : FVector::ZeroVector);
+		const FVector ForceAccel = Acceleration + (IsFalling() ? GetGravityVector() : FVector::ZeroVector);
 		ApplyImpactPhysicsForces(Impact, ForceAccel, Velocity);
 	}
 }
@@ -1436,6 +1872,8 @@ void UHynmersMovementComponent::ApplyImpactPhysicsForces(const FHitResult & Impa
 
 float UHynmersMovementComponent::SlideAlongSurface(const FVector & Delta, float Time, const FVector & InNormal, FHitResult & Hit, bool bHandleImpact)
 {
+	SCOPE_CYCLE_COUNTER(STAT_CharSlideAlongSurface);
+
 	if (!Hit.bBlockingHit)
 	{
 		return 0.f;
@@ -1449,7 +1887,7 @@ float UHynmersMovementComponent::SlideAlongSurface(const FVector & Delta, float
 		{
 			if (!IsWalkable(Hit))
 			{
-				Normal -= (Normal | UpVector)*UpVector;
+				Normal = HynmersTangentMath::ProjectOnPlane(Normal, UpVector);
 			}
 		}
 		else if ((Normal | UpVector) < -KINDA_SMALL_NUMBER)
@@ -1464,7 +1902,7 @@ float UHynmersMovementComponent::SlideAlongSurface(const FVector & Delta, float
 					Normal = FloorNormal;
 				}
 
-				Normal -= (Normal | UpVector)*UpVector;
+				Normal = HynmersTangentMath::ProjectOnPlane(Normal, UpVector);
 			}
 		}
 	}
@@ -1532,6 +1970,10 @@ void UHynmersMovementComponent::FindFloor(const FVector & CapsuleLocation, FFind
 
 	check(CharacterOwner->GetCapsuleComponent());
 
+	UHynmersMovementComponent* MutableThis = const_cast<UHynmersMovementComponent*>(this);
+	const bool bFloorWasRebased = bFloorRebased;
+	MutableThis->bFloorRebased = false;
+
 	// Increase height check slightly if walking, to prevent floor height adjustment from later invalidating the floor result.
 	const float HeightCheckAdjust = (IsMovingOnGround() ? MAX_FLOOR_DIST + KINDA_SMALL_NUMBER : -MAX_FLOOR_DIST);
 
@@ -1539,14 +1981,33 @@ void UHynmersMovementComponent::FindFloor(const FVector & CapsuleLocation, FFind
 	float FloorLineTraceDist = FloorSweepTraceDist;
 	bool bNeedToValidateFloor = true;
 
+	// The base carried us rigidly and we did not move on our own, the floor moved with it.
+	// Checked before bAlwaysCheckFloor, which is set for every Hynmers character.
+	if (bFloorWasRebased && bZeroDelta && !bForceNextFloorCheck && !bJustTeleported && DownwardSweepResult == NULL)
+	{
+		const UPrimitiveComponent* MovementBase = CharacterOwner->GetMovementBase();
+		if (MovementBase && MovementBase == CurrentFloor.HitResult.Component.Get())
+		{
+			HYNMERS_COUNT(RebasedFloors, STAT_HynmersRebasedFloors, MovementMode);
+			OutFloorResult = CurrentFloor;
+			return;
+		}
+	}
+
 	// Sweep floor
 	if (FloorLineTraceDist > 0.f || FloorSweepTraceDist > 0.f)
 	{
-		UHynmersMovementComponent* MutableThis = const_cast<UHynmersMovementComponent*>(this);
-
 		if (bAlwaysCheckFloor || !bZeroDelta || bForceNextFloorCheck || bJustTeleported)
 		{
+			const bool bCanUseCache = !bForceNextFloorCheck && !bJustTeleported && DownwardSweepResult == NULL;
 			MutableThis->bForceNextFloorCheck = false;
+
+			if (bCanUseCache && GetCachedFloor(CapsuleLocation, HeightCheckAdjust, OutFloorResult))
+			{
+				// Cached results are stored after validation
+				return;
+			}
+
 			ComputeFloorDist(CapsuleLocation, FloorLineTraceDist, FloorSweepTraceDist, OutFloorResult, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius(), DownwardSweepResult);
 		}
 		else
@@ -1580,8 +2041,17 @@ void UHynmersMovementComponent::FindFloor(const FVector & CapsuleLocation, FFind
 	}
 
 	// OutFloorResult.HitResult is now the result of the vertical floor check.
+	if (bNeedToValidateFloor)
+	{
+		ValidatePerchedFloor(OutFloorResult, HeightCheckAdjust);
+		CacheFloor(CapsuleLocation, HeightCheckAdjust, OutFloorResult);
+	}
+}
+
+void UHynmersMovementComponent::ValidatePerchedFloor(FFindFloorResult& OutFloorResult, float HeightCheckAdjust) const
+{
 	// See if we should try to "perch" at this location.
-	if (bNeedToValidateFloor && OutFloorResult.bBlockingHit && !OutFloorResult.bLineTrace)
+	if (OutFloorResult.bBlockingHit && !OutFloorResult.bLineTrace)
 	{
 		const bool bCheckRadius = true;
 		if (ShouldComputePerchResult(OutFloorResult.HitResult, bCheckRadius))
@@ -1618,6 +2088,135 @@ void UHynmersMovementComponent::FindFloor(const FVector & CapsuleLocation, FFind
 	}
 }
 
+void UHynmersMovementComponent::PrefetchFloor()
+{
+	bHasPrefetchedFloor = false;
+
+	// Same as the floor check FindFloor does when walking, without touching any state other than the result.
+	// Characters on moving bases move with the base first, a floor found here would be stale.
+	// Only for moves of this tick, CurrentFloor of remote players is where their next server move starts.
+	if (!HasValidData() || !IsMovedByLocalTick() || !IsMovingOnGround() || !UpdatedComponent->IsQueryCollisionEnabled() || MovementBaseUtility::UseRelativeLocation(GetMovementBase()))
+	{
+		return;
+	}
+
+	const float HeightCheckAdjust = MAX_FLOOR_DIST + KINDA_SMALL_NUMBER;
+	const float FloorTraceDist = FMath::Max(MAX_FLOOR_DIST, MaxStepHeight + HeightCheckAdjust);
+	const FVector CapsuleLocation = UpdatedComponent->GetComponentLocation();
+
+	FFindFloorResult FloorResult;
+	if (bForceNextFloorCheck || bJustTeleported || !GetCachedFloor(CapsuleLocation, HeightCheckAdjust, FloorResult))
+	{
+		ComputeFloorDist(CapsuleLocation, FloorTraceDist, FloorTraceDist, FloorResult, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius());
+		ValidatePerchedFloor(FloorResult, HeightCheckAdjust);
+		CacheFloor(CapsuleLocation, HeightCheckAdjust, FloorResult);
+	}
+
+	CurrentFloor = FloorResult;
+	PrefetchedFloorLocation = CapsuleLocation;
+	PrefetchedFloorUpVector = UpdatedComponent->GetUpVector();
+	bHasPrefetchedFloor = true;
+}
+
+bool UHynmersMovementComponent::IsMovedByLocalTick() const
+{
+	// Same conditions as TickComponent
+	if (!CharacterOwner || CharacterOwner->Role <= ROLE_SimulatedProxy)
+	{
+		return false;
+	}
+
+	const bool bIsClient = (CharacterOwner->Role == ROLE_AutonomousProxy && IsNetMode(NM_Client));
+	if (CharacterOwner->Role != ROLE_Authority && !bIsClient)
+	{
+		return false;
+	}
+
+	return CharacterOwner->IsLocallyControlled() || (!CharacterOwner->Controller && (bRunPhysicsWithNoController || CharacterOwner->IsPlayingRootMotion()));
+}
+
+void UHynmersMovementComponent::RequestFloorPrediction(float DeltaTime)
+{
+	FloorPredictionHandle = FTraceHandle();
+	if (!IsMovingOnGround() || !CurrentFloor.IsWalkableFloor() || !UpdatedComponent->IsQueryCollisionEnabled() || MovementBaseUtility::UseRelativeLocation(GetMovementBase()))
+	{
+		return;
+	}
+
+	float PawnRadius, PawnHalfHeight;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
+
+	// Same distances as the walking FindFloor sweep
+	const float HeightCheckAdjust = MAX_FLOOR_DIST + KINDA_SMALL_NUMBER;
+	PredictedSweepDist = FMath::Max(MAX_FLOOR_DIST, MaxStepHeight + HeightCheckAdjust);
+	PredictedShrinkHeight = (PawnHalfHeight - PawnRadius) * 0.1f;
+	PredictedTraceDist = PredictedSweepDist + PredictedShrinkHeight;
+	PredictedSphereOffset = PawnHalfHeight - PredictedShrinkHeight - PawnRadius;
+
+	PredictedFloorUpVector = UpdatedComponent->GetUpVector();
+	PredictedFloorLocation = UpdatedComponent->GetComponentLocation() + HynmersTangentMath::ProjectOnPlane(Velocity, PredictedFloorUpVector) * DeltaTime;
+
+	// The bottom sphere of the capsule gives the same floor contact without depending on the sweep rotation
+	const FVector SphereStart = PredictedFloorLocation - PredictedFloorUpVector * PredictedSphereOffset;
+	const FVector SphereEnd = SphereStart - PredictedFloorUpVector * PredictedTraceDist;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ComputeFloorDist), false, CharacterOwner);
+	FCollisionResponseParams ResponseParam;
+	InitCollisionParams(QueryParams, ResponseParam);
+
+	HYNMERS_COUNT(Sweeps, STAT_HynmersSweeps, MovementMode);
+	FloorPredictionHandle = GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, SphereStart, SphereEnd, UpdatedComponent->GetCollisionObjectType(),
+		FCollisionShape::MakeSphere(PawnRadius), QueryParams, ResponseParam);
+}
+
+bool UHynmersMovementComponent::ConsumeFloorPrediction(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult)
+{
+	if (!FloorPredictionHandle.IsValid())
+	{
+		return false;
+	}
+
+	// Single use, later iterations of this tick are somewhere else
+	FTraceDatum TraceData;
+	const bool bReady = GetWorld()->QueryTraceData(FloorPredictionHandle, TraceData);
+	FloorPredictionHandle = FTraceHandle();
+
+	const FVector Offset = CapsuleLocation - PredictedFloorLocation;
+	if (!bReady || bForceNextFloorCheck || bJustTeleported || TraceData.OutHits.Num() == 0
+		|| Offset.SizeSquared() > FMath::Square(AsyncFloorPredictionTolerance)
+		|| (UpdatedComponent->GetUpVector() | PredictedFloorUpVector) < THRESH_NORMALS_ARE_PARALLEL)
+	{
+		return false;
+	}
+
+	const FHitResult& SphereHit = TraceData.OutHits[0];
+	if (!SphereHit.bBlockingHit || SphereHit.bStartPenetrating)
+	{
+		return false;
+	}
+
+	// Back to a capsule hit at the actual location
+	FHitResult Hit = SphereHit;
+	const FVector CapsuleOffset = PredictedFloorUpVector * PredictedSphereOffset + Offset;
+	Hit.Location += CapsuleOffset;
+	Hit.TraceStart += CapsuleOffset;
+	Hit.TraceEnd += CapsuleOffset;
+
+	const float FloorDist = Hit.Time * PredictedTraceDist - PredictedShrinkHeight + (Offset | PredictedFloorUpVector);
+	if (FloorDist < -MAX_FLOOR_DIST || FloorDist > PredictedSweepDist
+		|| !IsWithinEdgeTolerance(Hit.Location, Hit.ImpactPoint, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius()) || !IsWalkable(Hit))
+	{
+		return false;
+	}
+
+	OutFloorResult.SetFromSweep(Hit, FloorDist, true);
+
+	const float HeightCheckAdjust = MAX_FLOOR_DIST + KINDA_SMALL_NUMBER;
+	ValidatePerchedFloor(OutFloorResult, HeightCheckAdjust);
+	CacheFloor(CapsuleLocation, HeightCheckAdjust, OutFloorResult);
+	return true;
+}
+
 void UHynmersMovementComponent::ComputeFloorDist(const FVector & CapsuleLocation, float LineDistance, float SweepDistance, FFindFloorResult & OutFloorResult, float SweepRadius, const FHitResult * DownwardSweepResult) const
 {
 	OutFloorResult.Clear();
@@ -1631,7 +2230,7 @@ void UHynmersMovementComponent::ComputeFloorDist(const FVector & CapsuleLocation
 		// Only if the supplied sweep was vertical and downward.
 		FVector TraceDifference = DownwardSweepResult->TraceStart - DownwardSweepResult->TraceEnd;
 		if (((DownwardSweepResult->TraceStart | UpVector) > (DownwardSweepResult->TraceEnd | UpVector)) &&
-			(TraceDifference-(TraceDifference | UpVector)*UpVector).SizeSquared() <= KINDA_SMALL_NUMBER)
+			HynmersTangentMath::ProjectOnPlane(TraceDifference, UpVector).SizeSquared() <= KINDA_SMALL_NUMBER)
 		{
 			// Reject hits that are barely on the cusp of the radius of the capsule
 			if (IsWithinEdgeTolerance(DownwardSweepResult->Location, DownwardSweepResult->ImpactPoint, PawnRadius))
@@ -1657,6 +2256,11 @@ void UHynmersMovementComponent::ComputeFloorDist(const FVector & CapsuleLocation
 		return;
 	}
 
+	if (!bSkipSweep && SweepDistance > 0.f && SweepRadius > 0.f && ComputeFloorDistFromField(CapsuleLocation, SweepDistance, SweepRadius, PawnHalfHeight, OutFloorResult))
+	{
+		return;
+	}
+
 	bool bBlockingHit = false;
 	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ComputeFloorDist), false, CharacterOwner);
 	FCollisionResponseParams ResponseParam;
@@ -1733,6 +2337,7 @@ void UHynmersMovementComponent::ComputeFloorDist(const FVector & CapsuleLocation
 		QueryParams.TraceTag = SCENE_QUERY_STAT_NAME_ONLY(FloorLineTrace);
 
 		FHitResult Hit(1.f);
+		HYNMERS_COUNT(LineTraces, STAT_HynmersLineTraces, MovementMode);
 		bBlockingHit = GetWorld()->LineTraceSingleByChannel(Hit, LineTraceStart, LineTraceStart + Down, CollisionChannel, QueryParams, ResponseParam);
 
 		if (bBlockingHit)
@@ -1754,12 +2359,82 @@ void UHynmersMovementComponent::ComputeFloorDist(const FVector & CapsuleLocation
 		}
 	}
 
-	UE_LOG(LogTemp, Warning, TEXT("No walkable floor found"))
-		// No hits were acceptable.
-		OutFloorResult.bWalkableFloor = false;
+	// No hits were acceptable.
+	MovementTrace.Record(EHynmersTraceEvent::FloorLost, MovementMode, CapsuleLocation, SweepDistance);
+	OutFloorResult.bWalkableFloor = false;
 	OutFloorResult.FloorDist = SweepDistance;
 }
 
+bool UHynmersMovementComponent::ComputeFloorDistFromField(const FVector& CapsuleLocation, float SweepDistance, float SweepRadius, float PawnHalfHeight, FFindFloorResult& OutFloorResult) const
+{
+	if (!bUseStaticDistanceField || bUseFlatBaseForFloorChecks)
+	{
+		return false;
+	}
+
+	AHynmersStaticDistanceField* Field = AHynmersStaticDistanceField::Find(GetWorld());
+	const ECollisionChannel CollisionChannel = UpdatedComponent->GetCollisionObjectType();
+	if (!Field || !Field->IsBaked() || Field->GetCollisionChannel() != CollisionChannel)
+	{
+		return false;
+	}
+
+	const FVector Up = UpdatedComponent->GetUpVector();
+	FHynmersFieldHit FieldHit;
+	const EHynmersFieldResult Result = Field->SweepCapsuleDown(CapsuleLocation, Up, SweepRadius, PawnHalfHeight, SweepDistance, FieldHit);
+	if (Result == EHynmersFieldResult::Ambiguous)
+	{
+		return false;
+	}
+
+	// The field only holds static geometry, anything movable near the swept capsule needs the scene query.
+	// Worker threads can not hash the movables, before the manager did it this frame they fall back too.
+	if (IsInGameThread())
+	{
+		Field->UpdateMovables();
+	}
+	if (!Field->AreMovablesUpToDate())
+	{
+		return false;
+	}
+
+	const float SweptHalfHeight = PawnHalfHeight + SweepDistance * 0.5f;
+	const FVector SweptExtent = FVector(SweepRadius) + Up.GetAbs() * FMath::Max(SweptHalfHeight - SweepRadius, 0.f);
+	if (Field->OverlapsMovable(FBox::BuildAABB(CapsuleLocation - Up * (SweepDistance * 0.5f), SweptExtent), CharacterOwner))
+	{
+		return false;
+	}
+
+	if (Result == EHynmersFieldResult::NoHit)
+	{
+		HYNMERS_COUNT(FieldFloors, STAT_HynmersFieldFloors, MovementMode);
+		OutFloorResult.FloorDist = SweepDistance;
+		return true;
+	}
+
+	FHitResult Hit(FieldHit.Distance / SweepDistance);
+	Hit.bBlockingHit = true;
+	Hit.TraceStart = CapsuleLocation;
+	Hit.TraceEnd = CapsuleLocation - Up * SweepDistance;
+	Hit.Location = CapsuleLocation - Up * FieldHit.Distance;
+	Hit.Distance = FieldHit.Distance;
+	Hit.ImpactPoint = FieldHit.ImpactPoint;
+	Hit.Normal = FieldHit.Normal;
+	Hit.ImpactNormal = FieldHit.Normal;
+	Hit.Component = FieldHit.Component;
+	Hit.Actor = FieldHit.Component->GetOwner();
+
+	// Edges and unwalkable surfaces go through the sweep and line trace fallbacks
+	if (!IsWithinEdgeTolerance(CapsuleLocation, Hit.ImpactPoint, SweepRadius) || !IsWalkable(Hit))
+	{
+		return false;
+	}
+
+	HYNMERS_COUNT(FieldFloors, STAT_HynmersFieldFloors, MovementMode);
+	OutFloorResult.SetFromSweep(Hit, FieldHit.Distance, true);
+	return true;
+}
+
 bool UHynmersMovementComponent::FloorSweepTest(FHitResult & OutHit, const FVector & Start, const FVector & End,
 	ECollisionChannel TraceChannel, const FCollisionShape & CollisionShape, const FCollisionQueryParams & Params,
 	const FCollisionResponseParams & ResponseParam) const
@@ -1768,24 +2443,20 @@ bool UHynmersMovementComponent::FloorSweepTest(FHitResult & OutHit, const FVecto
 
 	if (!bUseFlatBaseForFloorChecks)
 	{
+		HYNMERS_COUNT(Sweeps, STAT_HynmersSweeps, MovementMode);
 		bBlockingHit = GetWorld()->SweepSingleByChannel(OutHit, Start, End, UpdatedComponent->GetComponentQuat(), TraceChannel, CollisionShape, Params, ResponseParam);
 	}
 	else
 	{
-		// Test with a box that is enclosed by the capsule.
+		// Test with a box that is enclosed by the capsule, in the capsule frame so its base lies on the floor whatever the up vector.
 		const float CapsuleRadius = CollisionShape.GetCapsuleRadius();
 		const float CapsuleHeight = CollisionShape.GetCapsuleHalfHeight();
 		const FCollisionShape BoxShape = FCollisionShape::MakeBox(FVector(CapsuleRadius * 0.707f, CapsuleRadius * 0.707f, CapsuleHeight));
 
-		// First test with the box rotated so the corners are along the major axes (ie rotated 45 degrees).
-		bBlockingHit = GetWorld()->SweepSingleByChannel(OutHit, Start, End, FQuat(FVector(0.f, 0.f, -1.f), PI * 0.25f), TraceChannel, BoxShape, Params, ResponseParam);
-
-		if (!bBlockingHit)
-		{
-			// Test again with the same box, not rotated.
-			OutHit.Reset(1.f, false);
-			bBlockingHit = GetWorld()->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, TraceChannel, BoxShape, Params, ResponseParam);
-		}
+		// Corners along the forward and right axes, a single sweep instead of a rotated and an unrotated one
+		static const FQuat CornerRotation(FVector(0.f, 0.f, -1.f), PI * 0.25f);
+		HYNMERS_COUNT(Sweeps, STAT_HynmersSweeps, MovementMode);
+		bBlockingHit = GetWorld()->SweepSingleByChannel(OutHit, Start, End, UpdatedComponent->GetComponentQuat() * CornerRotation, TraceChannel, BoxShape, Params, ResponseParam);
 	}
 
 	return bBlockingHit;
@@ -1798,12 +2469,6 @@ bool UHynmersMovementComponent::IsWalkable(const FHitResult & Hit) const
 		// No hit, or starting in penetration
 		return false;
 	}
-	
-	// Never walk up vertical surfaces.
-	if ((Hit.ImpactNormal | UpdatedComponent->GetUpVector()) < KINDA_SMALL_NUMBER)
-	{
-		return false;
-	}
 
 	float TestWalkableZ = GetWalkableFloorZ();
 
@@ -1815,15 +2480,85 @@ bool UHynmersMovementComponent::IsWalkable(const FHitResult & Hit) const
 		TestWalkableZ = SlopeOverride.ModifyWalkableFloorZ(TestWalkableZ);
 	}
 
-	// Can't walk on this surface if it is too steep.
-	if ((Hit.ImpactNormal | UpdatedComponent->GetUpVector())  < TestWalkableZ)
+	if (FHynmersCoreRecorder::IsRecording())
+	{
+		FHynmersCoreRecorder::Record(FHynmersCoreCall(EHynmersCoreKernel::IsWalkableNormal, FHynmersMovementFrame(), Hit.ImpactNormal, UpdatedComponent->GetUpVector(), FVector::ZeroVector, TestWalkableZ));
+	}
+	return HynmersMovementCore::IsWalkableNormal(Hit.ImpactNormal, UpdatedComponent->GetUpVector(), TestWalkableZ);
+}
+
+void UHynmersMovementComponent::OnTeleported()
+{
+	FloorCache.Invalidate();
+	LastWaterBody.Reset();
+	FloorPredictionHandle = FTraceHandle();
+	LedgeProbe.Invalidate();
+	bHasPreviousSimState = false;
+
+	Super::OnTeleported();
+}
+
+bool UHynmersMovementComponent::GetCachedFloor(const FVector& CapsuleLocation, float HeightCheckAdjust, FFindFloorResult& OutFloorResult) const
+{
+	if (!bUseFloorCache || !FloorCache.bValid || FloorCache.HeightCheckAdjust != HeightCheckAdjust)
+	{
+		return false;
+	}
+
+	const FVector CurrentUp = UpdatedComponent->GetUpVector();
+	const FVector Displacement = CapsuleLocation - FloorCache.Location;
+	if ((CurrentUp | FloorCache.UpVector) < THRESH_NORMALS_ARE_PARALLEL || Displacement.SizeSquared() > FMath::Square(FloorCacheTolerance))
+	{
+		return false;
+	}
+
+	// The base must still be static and blocking us
+	const UPrimitiveComponent* Base = FloorCache.Base.Get();
+	if (!Base || MovementBaseUtility::IsDynamicBase(Base) || !Base->IsQueryCollisionEnabled()
+		|| Base->GetCollisionResponseToChannel(UpdatedComponent->GetCollisionObjectType()) != ECR_Block)
+	{
+		FloorCache.Invalidate();
+		return false;
+	}
+
+	float PawnRadius, PawnHalfHeight;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
+	if (PawnRadius != FloorCache.CapsuleRadius || PawnHalfHeight != FloorCache.CapsuleHalfHeight)
 	{
+		FloorCache.Invalidate();
 		return false;
 	}
 
+	OutFloorResult = FloorCache.Floor;
+
+	// Account for the small displacement along the up vector
+	const float Rise = Displacement | CurrentUp;
+	OutFloorResult.FloorDist += Rise;
+	if (OutFloorResult.bLineTrace)
+	{
+		OutFloorResult.LineDist += Rise;
+	}
 	return true;
 }
 
+void UHynmersMovementComponent::CacheFloor(const FVector& CapsuleLocation, float HeightCheckAdjust, const FFindFloorResult& FloorResult) const
+{
+	const UPrimitiveComponent* Base = FloorResult.HitResult.Component.Get();
+	if (!bUseFloorCache || !FloorResult.IsWalkableFloor() || !Base || MovementBaseUtility::IsDynamicBase(Base))
+	{
+		FloorCache.Invalidate();
+		return;
+	}
+
+	FloorCache.Floor = FloorResult;
+	FloorCache.Location = CapsuleLocation;
+	FloorCache.UpVector = UpdatedComponent->GetUpVector();
+	FloorCache.Base = Base;
+	FloorCache.HeightCheckAdjust = HeightCheckAdjust;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(FloorCache.CapsuleRadius, FloorCache.CapsuleHalfHeight);
+	FloorCache.bValid = true;
+}
+
 void UHynmersMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 {
 	SCOPE_CYCLE_COUNTER(STAT_CharPhysFalling);
@@ -1834,13 +2569,15 @@ void UHynmersMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 	}
 
 	FVector FallAcceleration = GetFallingLateralAcceleration(deltaTime);
-	FallAcceleration -= (FallAcceleration | UpVector)*UpVector;
+	FallAcceleration = HynmersTangentMath::ProjectOnPlane(FallAcceleration, UpVector);
 	const bool bHasAirControl = (FallAcceleration.SizeSquared() > 0.f);
 
 	float remainingTime = deltaTime;
 	while ((remainingTime >= MIN_TICK_TIME) && (Iterations < MaxSimulationIterations))
 	{
 		Iterations++;
+		HYNMERS_COUNT(Iterations, STAT_HynmersIterations, MovementMode);
+		INC_DWORD_STAT(STAT_HynmersIterationsFalling);
 		const float timeTick = GetSimulationTimeStep(remainingTime, Iterations);
 		remainingTime -= timeTick;
 
@@ -1863,19 +2600,20 @@ void UHynmersMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 				// Find velocity *without* acceleration.
 				TGuardValue<FVector> RestoreAcceleration(Acceleration, FVector::ZeroVector);
 				TGuardValue<FVector> RestoreVelocity(Velocity, Velocity);
-				Velocity -= (Velocity | UpVector)*UpVector;
+				// This velocity is thrown away, the avoidance correction goes to the one computed below
+				TGuardValue<bool> RestoreAvoidanceCorrection(bHasAvoidanceCorrection, false);
+				Velocity = HynmersTangentMath::ProjectOnPlane(Velocity, UpVector);
 				CalcVelocity(timeTick, FallingLateralFriction, false, MaxDecel);
-				VelocityNoAirControl = (Velocity | ForwardVector)*ForwardVector
-					+ (Velocity | RightVector)*RightVector + (OldVelocity | UpVector)*UpVector;
+				VelocityNoAirControl = HynmersTangentMath::ProjectOnAxes(Velocity, ForwardVector, RightVector, UpVector, OldVelocity | UpVector);
 			}
 
 			// Compute Velocity
 			{
 				// Acceleration = FallAcceleration for CalcVelocity(), but we restore it after using it.
 				TGuardValue<FVector> RestoreAcceleration(Acceleration, FallAcceleration);
-				Velocity -= (Velocity | UpVector)*UpVector;;
+				Velocity = HynmersTangentMath::ProjectOnPlane(Velocity, UpVector);
 				CalcVelocity(timeTick, FallingLateralFriction, false, MaxDecel);
-				Velocity = Velocity + (OldVelocity | UpVector)*UpVector - (Velocity | UpVector)*UpVector;
+				Velocity = HynmersTangentMath::ProjectOnPlane(Velocity, UpVector) + (OldVelocity | UpVector)*UpVector;
 			}
 
 			// Just copy Velocity to VelocityNoAirControl if they are the same (ie no acceleration).
@@ -1886,7 +2624,7 @@ void UHynmersMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 		}
 
 		// Apply gravity
-		const FVector Gravity = GetGravityZ()*UpVector;
+		const FVector Gravity = GetGravityVector();
 		Velocity = NewFallVelocity(Velocity, Gravity, timeTick);
 		VelocityNoAirControl = NewFallVelocity(VelocityNoAirControl, Gravity, timeTick);
 		const FVector AirControlAccel = (Velocity - VelocityNoAirControl) / timeTick;
@@ -1973,8 +2711,7 @@ void UHynmersMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 				if (subTimeTickRemaining > KINDA_SMALL_NUMBER && !bJustTeleported)
 				{
 					const FVector NewVelocity = (Delta / subTimeTickRemaining);
-					Velocity = HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() ? (Velocity | RightVector)*RightVector
-						+ (Velocity | ForwardVector)*ForwardVector + (NewVelocity*UpVector)*UpVector: NewVelocity;
+					Velocity = HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() ? HynmersTangentMath::ProjectOnAxes(Velocity, RightVector, ForwardVector, UpVector, NewVelocity | UpVector) : NewVelocity;
 				}
 
 				if (subTimeTickRemaining > KINDA_SMALL_NUMBER && (Delta | Adjusted) > 0.f)
@@ -2030,8 +2767,7 @@ void UHynmersMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 						if (subTimeTickRemaining > KINDA_SMALL_NUMBER && !bJustTeleported)
 						{
 							const FVector NewVelocity = (Delta / subTimeTickRemaining);
-							Velocity = HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() ? (Velocity | RightVector)*RightVector
-								+ (Velocity | ForwardVector)*ForwardVector + (NewVelocity*UpVector)*UpVector : NewVelocity;
+							Velocity = HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() ? HynmersTangentMath::ProjectOnAxes(Velocity, RightVector, ForwardVector, UpVector, NewVelocity | UpVector) : NewVelocity;
 						}
 
 						// bDitch=true means that pawn is straddling two slopes, neither of which he can stand on
@@ -2040,7 +2776,7 @@ void UHynmersMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 						if (Hit.Time == 0.f)
 						{
 							// if we are stuck then try to side step
-							FVector SideDelta = ((OldHitNormal + Hit.ImpactNormal)-((OldHitNormal + Hit.ImpactNormal)| UpVector)*UpVector).GetSafeNormal();
+							FVector SideDelta = HynmersTangentMath::ProjectOnPlaneSafeNormal(OldHitNormal + Hit.ImpactNormal, UpVector);
 							if (SideDelta.IsNearlyZero())
 							{
 
@@ -2061,12 +2797,12 @@ void UHynmersMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 							// We might be in a virtual 'ditch' within our perch radius. This is rare.
 							const FVector PawnLocation = UpdatedComponent->GetComponentLocation();
 							const float ZMovedDist = FMath::Abs((PawnLocation | UpVector) - (OldLocation | UpVector));
-							const float MovedDist2DSq = ((PawnLocation - OldLocation) - ((PawnLocation - OldLocation) | UpVector)*UpVector).SizeSquared();
+							const float MovedDist2DSq = HynmersTangentMath::ProjectOnPlane(PawnLocation - OldLocation, UpVector).SizeSquared();
 							if (ZMovedDist <= 0.2f * timeTick && MovedDist2DSq <= 4.f * timeTick)
 							{
 								Velocity += 0.25f * GetMaxSpeed() * (FMath::FRand() - 0.5f)*ForwardVector;
 								Velocity += 0.25f * GetMaxSpeed() * (FMath::FRand() - 0.5f)*RightVector;
-								Velocity = Velocity + FMath::Max<float>(JumpZVelocity * 0.25f, 1.f)*UpVector - (Velocity | UpVector)*UpVector;
+								Velocity = HynmersTangentMath::ProjectOnPlane(Velocity, UpVector) + FMath::Max<float>(JumpZVelocity * 0.25f, 1.f)*UpVector;
 								Delta = Velocity * timeTick;
 								SafeMoveUpdatedComponent(Delta, PawnRotation, true, Hit);
 							}
@@ -2076,17 +2812,23 @@ void UHynmersMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 			}
 		}
 
-		if ((Velocity-(Velocity|UpVector)*UpVector).SizeSquared() <= KINDA_SMALL_NUMBER * 10.f)
+		if (HynmersTangentMath::ProjectOnPlane(Velocity, UpVector).SizeSquared() <= KINDA_SMALL_NUMBER * 10.f)
 		{
 			Velocity = (Velocity | UpVector)*UpVector;
 		}
 	}
+
+	if (remainingTime >= MIN_TICK_TIME && Iterations >= MaxSimulationIterations)
+	{
+		HYNMERS_COUNT(IterationCaps, STAT_HynmersIterationCaps, MovementMode);
+		MovementTrace.Record(EHynmersTraceEvent::IterationCap, MovementMode, Velocity, remainingTime, Iterations);
+	}
 }
 
 FVector UHynmersMovementComponent::GetFallingLateralAcceleration(float DeltaTime)
 {
 	// No acceleration in Z
-	FVector FallAcceleration = (Acceleration | ForwardVector)*ForwardVector + (Acceleration | RightVector)*RightVector;
+	FVector FallAcceleration = HynmersTangentMath::ProjectOnAxes(Acceleration, ForwardVector, RightVector);
 
 	// bound acceleration, falling object has minimal ability to impact acceleration
 	if (!HasAnimRootMotion() && FallAcceleration.SizeSquared() > 0.f)
@@ -2100,13 +2842,13 @@ FVector UHynmersMovementComponent::GetFallingLateralAcceleration(float DeltaTime
 
 bool UHynmersMovementComponent::DoJump(bool bReplayingMoves)
 {
-	UE_LOG(LogTemp, Warning, TEXT("JUMP_TIME: %d"), GetWorld()->GetTimeSeconds())
+	MovementTrace.Record(EHynmersTraceEvent::Jump, MovementMode, Velocity);
 	if (CharacterOwner && CharacterOwner->CanJump())
 	{
 		// Don't jump if we can't move up/down.
 		if (!bConstrainToPlane || FMath::Abs(PlaneConstraintNormal | UpVector) != 1.f)
 		{
-			Velocity = (Velocity | RightVector)*RightVector + (Velocity | ForwardVector)*ForwardVector + JumpZVelocity*UpVector;
+			Velocity = HynmersTangentMath::ProjectOnAxes(Velocity, RightVector, ForwardVector, UpVector, JumpZVelocity);
 			SetMovementMode(MOVE_Falling);
 			return true;
 		}
@@ -2117,9 +2859,9 @@ bool UHynmersMovementComponent::DoJump(bool bReplayingMoves)
 
 float UHynmersMovementComponent::BoostAirControl(float DeltaTime, float TickAirControl, const FVector & FallAcceleration)
 {
-	UE_LOG(LogTemp, Warning, TEXT("Im in BoostAirControl"))
-	if (AirControlBoostMultiplier > 0.f && (Velocity-(Velocity | UpVector)*UpVector).SizeSquared() < FMath::Square(AirControlBoostVelocityThreshold))
+	if (AirControlBoostMultiplier > 0.f && HynmersTangentMath::ProjectOnPlane(Velocity, UpVector).SizeSquared() < FMath::Square(AirControlBoostVelocityThreshold))
 	{
+		MovementTrace.Record(EHynmersTraceEvent::AirControlBoost, MovementMode, FallAcceleration, TickAirControl);
 		TickAirControl = FMath::Min(1.f, AirControlBoostMultiplier * TickAirControl);
 	}
 
@@ -2128,7 +2870,7 @@ float UHynmersMovementComponent::BoostAirControl(float DeltaTime, float TickAirC
 
 void UHynmersMovementComponent::ProcessLanded(const FHitResult & Hit, float remainingTime, int32 Iterations)
 {
-	UE_LOG(LogTemp, Warning, TEXT("Im Landing"))
+	MovementTrace.Record(EHynmersTraceEvent::Landed, MovementMode, Hit.ImpactNormal, Velocity | UpVector);
 	if (CharacterOwner && CharacterOwner->ShouldNotifyLanded(Hit))
 	{
 		CharacterOwner->Landed(Hit);
@@ -2205,7 +2947,7 @@ void UHynmersMovementComponent::SetPostLandedPhysics(const FHitResult & Hit)
 		}
 		else
 		{
-			const FVector PreImpactAccel = Acceleration + (IsFalling() ? GetGravityZ()*UpVector : FVector::ZeroVector);
+			const FVector PreImpactAccel = Acceleration + (IsFalling() ? GetGravityVector() : FVector::ZeroVector);
 			const FVector PreImpactVelocity = Velocity;
 
 			if (DefaultLandMovementMode == MOVE_Walking ||
@@ -2226,126 +2968,42 @@ void UHynmersMovementComponent::SetPostLandedPhysics(const FHitResult & Hit)
 
 FVector UHynmersMovementComponent::LimitAirControl(float DeltaTime, const FVector & FallAcceleration, const FHitResult & HitResult, bool bCheckForValidLandingSpot)
 {
-	FVector Result(FallAcceleration);
-
-	if (HitResult.IsValidBlockingHit() && (HitResult.Normal | UpVector) > VERTICAL_SLOPE_NORMAL_Z)
-	{
-		if (!bCheckForValidLandingSpot || !IsValidLandingSpot(HitResult.Location, HitResult))
-		{
-			// If acceleration is into the wall, limit contribution.
-			if (FVector::DotProduct(FallAcceleration, HitResult.Normal) < 0.f)
-			{
-				// Allow movement parallel to the wall, but not into it because that may push us up.
-				const FVector Normal2D = (HitResult.Normal - (HitResult.Normal | UpVector)*UpVector).GetSafeNormal();
-				Result = FVector::VectorPlaneProject(FallAcceleration, Normal2D);
-			}
-		}
-	}
-	else if (HitResult.bStartPenetrating)
+	const bool bWallHit = HitResult.IsValidBlockingHit() && (HitResult.Normal | UpVector) > VERTICAL_SLOPE_NORMAL_Z;
+	const bool bLimitIntoWall = bWallHit && (!bCheckForValidLandingSpot || !IsValidLandingSpot(HitResult.Location, HitResult));
+	if (FHynmersCoreRecorder::IsRecording())
 	{
-		// Allow movement out of penetration.
-		return (FVector::DotProduct(Result, HitResult.Normal) > 0.f ? Result : FVector::ZeroVector);
+		FHynmersCoreRecorder::Record(FHynmersCoreCall(EHynmersCoreKernel::LimitAirControl, GetMovementFrame(), FallAcceleration, HitResult.Normal, FVector::ZeroVector, 0.f, bWallHit, bLimitIntoWall, HitResult.bStartPenetrating));
 	}
-
-	return Result;
+	return HynmersMovementCore::LimitAirControl(GetMovementFrame(), FallAcceleration, HitResult.Normal, bWallHit, bLimitIntoWall, HitResult.bStartPenetrating);
 }
 
 FVector UHynmersMovementComponent::HandleSlopeBoosting(const FVector & SlideResult, const FVector & Delta, const float Time, const FVector & Normal, const FHitResult & Hit) const
 {
-	FVector Result = SlideResult;
-
-	if ((Result | UpVector) > 0.f)
+	if (FHynmersCoreRecorder::IsRecording())
 	{
-		// Don't move any higher than we originally intended.
-		const float ZLimit = (Delta | UpVector) * Time;
-		if ((Result | UpVector) - ZLimit > KINDA_SMALL_NUMBER)
-		{
-			if (ZLimit > 0.f)
-			{
-				// Rescale the entire vector (not just the Z component) otherwise we change the direction and likely head right back into the impact.
-				const float UpPercent = ZLimit / (Result | UpVector);
-				Result *= UpPercent;
-			}
-			else
-			{
-				// We were heading down but were going to deflect upwards. Just make the deflection horizontal.
-				Result = FVector::ZeroVector;
-			}
-
-			// Make remaining portion of original result horizontal and parallel to impact normal.
-			const FVector RemainderXY = ((SlideResult - Result) | ForwardVector)*ForwardVector + ((SlideResult - Result) | RightVector)*RightVector;
-			const FVector NormalXY = (Normal -(Normal|UpVector)*UpVector).GetSafeNormal();
-			const FVector Adjust = UMovementComponent::ComputeSlideVector(RemainderXY, 1.f, NormalXY, Hit);
-			Result += Adjust;
-		}
+		FHynmersCoreRecorder::Record(FHynmersCoreCall(EHynmersCoreKernel::HandleSlopeBoosting, GetMovementFrame(), SlideResult, Delta, Normal, Time));
 	}
-
-	return Result;
+	return HynmersMovementCore::HandleSlopeBoosting(GetMovementFrame(), SlideResult, Delta, Time, Normal);
 }
 
 void UHynmersMovementComponent::TwoWallAdjust(FVector & Delta, const FHitResult & Hit, const FVector & OldHitNormal) const
 {
-	const FVector InDelta = Delta;
+	SCOPE_CYCLE_COUNTER(STAT_CharTwoWallAdjust);
 
-	const FVector HitNormal = Hit.Normal;
-
-	if ((OldHitNormal | HitNormal) <= 0.f) //90 or less corner, so use cross product for direction
-	{
-		const FVector DesiredDir = Delta;
-		FVector NewDir = (HitNormal ^ OldHitNormal);
-		NewDir = NewDir.GetSafeNormal();
-		Delta = (Delta | NewDir) * (1.f - Hit.Time) * NewDir;
-		if ((DesiredDir | Delta) < 0.f)
-		{
-			Delta = -1.f * Delta;
-		}
-	}
-	else //adjust to new wall
-	{
-		const FVector DesiredDir = Delta;
-		Delta = UMovementComponent::ComputeSlideVector(Delta, 1.f - Hit.Time, HitNormal, Hit);
-		if ((Delta | DesiredDir) <= 0.f)
-		{
-			Delta = FVector::ZeroVector;
-		}
-		else if (FMath::Abs((HitNormal | OldHitNormal) - 1.f) < KINDA_SMALL_NUMBER)
-		{
-			// we hit the same wall again even after adjusting to move along it the first time
-			// nudge away from it (this can happen due to precision issues)
-			Delta += HitNormal * 0.01f;
-		}
-	}
-	
-	if (IsMovingOnGround())
+	const bool bMovingOnGround = IsMovingOnGround();
+	const bool bHitWalkable = bMovingOnGround && ((Hit.Normal | UpVector) >= GetWalkableFloorZ() || IsWalkable(Hit));
+	const bool bFloorTooClose = CurrentFloor.FloorDist < MIN_FLOOR_DIST && CurrentFloor.bBlockingHit;
+	if (FHynmersCoreRecorder::IsRecording())
 	{
-		// Allow slides up walkable surfaces, but not unwalkable ones (treat those as vertical barriers).
-		if ((Delta | UpVector) > 0.f)
-		{
-			if (((Hit.Normal | UpVector) >= GetWalkableFloorZ() || IsWalkable(Hit)) && (Hit.Normal | UpVector) > KINDA_SMALL_NUMBER)
-			{
-				// Maintain horizontal velocity
-				const float Time = (1.f - Hit.Time);
-				const FVector ScaledDelta = Delta.GetSafeNormal() * InDelta.Size();
-				Delta = ((InDelta | ForwardVector)*ForwardVector + (InDelta | RightVector)*RightVector + ((ScaledDelta | UpVector) / (Hit.Normal | UpVector))*UpVector)*Time;
-			}
-			else
-			{
-				Delta -= (Delta | UpVector)*UpVector;
-			}
-		}
-		else if ((Delta | UpVector) < 0.f)
-		{
-			// Don't push down into the floor.
-			if (CurrentFloor.FloorDist < MIN_FLOOR_DIST && CurrentFloor.bBlockingHit)
-			{
-				Delta -= (Delta | UpVector)*UpVector;
-			}
-		}
+		FHynmersCoreRecorder::Record(FHynmersCoreCall(EHynmersCoreKernel::TwoWallAdjust, GetMovementFrame(), Delta, Hit.Normal, OldHitNormal, Hit.Time, bMovingOnGround, bHitWalkable, bFloorTooClose));
 	}
+	HynmersMovementCore::TwoWallAdjust(GetMovementFrame(), Delta, Hit.Time, Hit.Normal, OldHitNormal, bMovingOnGround, bHitWalkable, bFloorTooClose);
 }
 
 void UHynmersMovementComponent::PhysSwimming(float deltaTime, int32 Iterations)
 {
+	SCOPE_CYCLE_COUNTER(STAT_CharPhysSwimming);
+
 	if (deltaTime < MIN_TICK_TIME)
 	{
 		return;
@@ -2353,6 +3011,9 @@ void UHynmersMovementComponent::PhysSwimming(float deltaTime, int32 Iterations)
 
 	RestorePreAdditiveRootMotionVelocity();
 
+	// Plain water volumes clear it, so FindWaterLine never uses a body left behind
+	LastWaterBody = Cast<AHynmersWaterBody>(GetPhysicsVolume());
+
 	float NetFluidFriction = 0.f;
 	float Depth = ImmersionDepth();
 	float NetBuoyancy = Buoyancy * Depth;
@@ -2362,22 +3023,24 @@ void UHynmersMovementComponent::PhysSwimming(float deltaTime, int32 Iterations)
 	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() && ((Velocity | UpVector) > 0.33f * MaxSwimSpeed) && (NetBuoyancy != 0.f))
 	{
 		//damp positive Z out of water
-		Velocity = (Velocity*ForwardVector)*ForwardVector + (Velocity | RightVector)*RightVector + FMath::Max(0.33f * MaxSwimSpeed, (Velocity | UpVector) * Depth*Depth)*UpVector;
+		Velocity = HynmersTangentMath::ProjectOnAxes(Velocity, ForwardVector, RightVector, UpVector, FMath::Max(0.33f * MaxSwimSpeed, (Velocity | UpVector) * Depth*Depth));
 	}
 	else if (Depth < 0.65f)
 	{
 		bLimitedUpAccel = ((Acceleration | UpVector) > 0.f);
-		Acceleration = Acceleration - (Acceleration | UpVector)*UpVector + FMath::Min(0.1f, (Acceleration | UpVector))*UpVector;
+		Acceleration = HynmersTangentMath::ProjectOnPlane(Acceleration, UpVector) + FMath::Min(0.1f, (Acceleration | UpVector))*UpVector;
 	}
 
 	Iterations++;
+	HYNMERS_COUNT(Iterations, STAT_HynmersIterations, MovementMode);
+	INC_DWORD_STAT(STAT_HynmersIterationsSwimming);
 	FVector OldLocation = UpdatedComponent->GetComponentLocation();
 	bJustTeleported = false;
 	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
 	{
 		const float Friction = 0.5f * GetPhysicsVolume()->FluidFriction * Depth;
 		CalcVelocity(deltaTime, Friction, true, GetMaxBrakingDeceleration());
-		Velocity += (GetGravityZ() * deltaTime * (1.f - NetBuoyancy))*UpVector;
+		Velocity += GetGravityVector() * (deltaTime * (1.f - NetBuoyancy));
 	}
 
 	ApplyRootMotionToVelocity(deltaTime);
@@ -2418,7 +3081,7 @@ void UHynmersMovementComponent::PhysSwimming(float deltaTime, int32 Iterations)
 		{
 			float stepZ = (UpdatedComponent->GetComponentLocation() | UpVector);
 			const FVector RealVelocity = Velocity;
-			Velocity = Velocity - (Velocity | UpVector)*UpVector + UpVector;	// HACK: since will be moving up, in case pawn leaves the water
+			Velocity = HynmersTangentMath::ProjectOnPlane(Velocity, UpVector) + UpVector;	// HACK: since will be moving up, in case pawn leaves the water
 			bSteppedUp = StepUp(GravDir, Adjusted * (1.f - Hit.Time), Hit);
 			if (bSteppedUp)
 			{
@@ -2466,6 +3129,8 @@ void UHynmersMovementComponent::PhysSwimming(float deltaTime, int32 Iterations)
 
 void UHynmersMovementComponent::StartSwimming(FVector OldLocation, FVector OldVelocity, float timeTick, float remainingTime, int32 Iterations)
 {
+	SCOPE_CYCLE_COUNTER(STAT_CharStartSwimming);
+
 	if (remainingTime < MIN_TICK_TIME || timeTick < MIN_TICK_TIME)
 	{
 		return;
@@ -2491,7 +3156,8 @@ void UHynmersMovementComponent::StartSwimming(FVector OldLocation, FVector OldVe
 	}
 	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() && ((Velocity | UpVector) > 2.f*SWIMBOBSPEED) && ((Velocity | UpVector) < 0.f)) //allow for falling out of water
 	{
-		Velocity = (Velocity - (Velocity | UpVector)*UpVector) + (SWIMBOBSPEED - (Velocity - (Velocity | UpVector)*UpVector).Size() * 0.7f)*UpVector; //smooth bobbing
+		const FVector TangentVelocity = HynmersTangentMath::ProjectOnPlane(Velocity, UpVector);
+		Velocity = TangentVelocity + (SWIMBOBSPEED - TangentVelocity.Size() * 0.7f)*UpVector; //smooth bobbing
 	}
 	if ((remainingTime >= MIN_TICK_TIME) && (Iterations < MaxSimulationIterations))
 	{
@@ -2501,6 +3167,8 @@ void UHynmersMovementComponent::StartSwimming(FVector OldLocation, FVector OldVe
 
 float UHynmersMovementComponent::ImmersionDepth() const
 {
+	SCOPE_CYCLE_COUNTER(STAT_CharImmersionDepth);
+
 	float depth = 0.f;
 
 	if (CharacterOwner && GetPhysicsVolume()->bWaterVolume)
@@ -2513,20 +3181,687 @@ float UHynmersMovementComponent::ImmersionDepth() const
 		}
 		else
 		{
-			UBrushComponent* VolumeBrushComp = GetPhysicsVolume()->GetBrushComponent();
-			FHitResult Hit(1.f);
-			if (VolumeBrushComp)
-			{
-				const FVector TraceStart = UpdatedComponent->GetComponentLocation() + CollisionHalfHeight * UpVector;
-				const FVector TraceEnd = UpdatedComponent->GetComponentLocation() - CollisionHalfHeight * UpVector;
+			const APhysicsVolume* Volume = GetPhysicsVolume();
+			const FVector Location = UpdatedComponent->GetComponentLocation();
+			const FVector TraceStart = Location + CollisionHalfHeight * UpVector;
+			const FVector TraceEnd = Location - CollisionHalfHeight * UpVector;
 
-				FCollisionQueryParams NewTraceParams(SCENE_QUERY_STAT(ImmersionDepth), true);
-				VolumeBrushComp->LineTraceComponent(Hit, TraceStart, TraceEnd, NewTraceParams);
+			const AHynmersWaterBody* WaterBody = Cast<AHynmersWaterBody>(Volume);
+			if (WaterBody && WaterBody->HasAnalyticSurface())
+			{
+				// Entering the water at Time leaves 1 - Time of the capsule under the surface
+				float Time;
+				if (WaterBody->TraceSurface(TraceStart, TraceEnd, Time))
+				{
+					depth = 1.f - Time;
+				}
+				else
+				{
+					depth = WaterBody->IsUnderSurface(TraceStart) ? 1.f : 0.f;
+				}
 			}
-
-			depth = (Hit.Time == 1.f) ? 1.f : (1.f - Hit.Time);
-		}
+			else
+			{
+				UBrushComponent* VolumeBrushComp = Volume->GetBrushComponent();
+				FHitResult Hit(1.f);
+				if (VolumeBrushComp)
+				{
+					FCollisionQueryParams NewTraceParams(SCENE_QUERY_STAT(ImmersionDepth), true);
+					HYNMERS_COUNT(LineTraces, STAT_HynmersLineTraces, MovementMode);
+					VolumeBrushComp->LineTraceComponent(Hit, TraceStart, TraceEnd, NewTraceParams);
+				}
+
+				depth = (Hit.Time == 1.f) ? 1.f : (1.f - Hit.Time);
+			}
+		}
 	}
 	return depth;
 }
 
+FVector UHynmersMovementComponent::FindWaterLine(FVector InWater, FVector OutofWater)
+{
+	// Swimming out of the water the current volume is already the one outside
+	const AHynmersWaterBody* WaterBody = Cast<AHynmersWaterBody>(GetPhysicsVolume());
+	const bool bInWaterBody = WaterBody != nullptr;
+	if (!WaterBody && !GetPhysicsVolume()->bWaterVolume)
+	{
+		WaterBody = LastWaterBody.Get();
+	}
+
+	float Time;
+	if (WaterBody && WaterBody->HasAnalyticSurface() && WaterBody->TraceSurface(OutofWater, InWater, Time))
+	{
+		// Same offsets as the brush trace, just inside the volume we are in or just outside the one we left
+		const FVector Dir = (InWater - OutofWater).GetSafeNormal();
+		const FVector WaterLine = OutofWater + (InWater - OutofWater) * Time;
+		return bInWaterBody ? WaterLine + 0.1f * Dir : WaterLine - 0.1f * Dir;
+	}
+
+	return Super::FindWaterLine(InWater, OutofWater);
+}
+
+float UHynmersMovementComponent::GetGravityZ() const
+{
+	if (bHasFieldGravity)
+	{
+		return -GravityMagnitude * GravityScale;
+	}
+	return Super::GetGravityZ();
+}
+
+FVector UHynmersMovementComponent::GetGravityVector() const
+{
+	if (bHasFieldGravity)
+	{
+		return GravityDirection * (GravityMagnitude * GravityScale);
+	}
+	return GetGravityZ()*UpVector;
+}
+
+FVector UHynmersMovementComponent::GetTargetUpVector() const
+{
+	// The gravity field is valid with or without a floor, the floor normal is only a guess of it
+	if (bHasFieldGravity)
+	{
+		return -GravityDirection;
+	}
+	return OrientationSolver.GetBlendedFloorNormal(CurrentFloor.HitResult.ImpactNormal);
+}
+
+void UHynmersMovementComponent::UpdateGravity()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharUpdateGravity);
+
+	bHasFieldGravity = false;
+
+	if (!bUseGravityField || !UpdatedComponent)
+	{
+		return;
+	}
+
+	AHynmersGravityManager* GravityManager = AHynmersGravityManager::Find(GetWorld());
+	FVector FieldGravity;
+	if (GravityManager && GravityManager->QueryGravity(UpdatedComponent->GetComponentLocation(), FieldGravity))
+	{
+		GravityMagnitude = FieldGravity.Size();
+		GravityDirection = FieldGravity / GravityMagnitude;
+		bHasFieldGravity = true;
+	}
+}
+
+bool UHynmersMovementComponent::CanSleep() const
+{
+	if (!HasValidData() || CharacterOwner->Role != ROLE_Authority || !IsMovingOnGround() || !CurrentFloor.IsWalkableFloor())
+	{
+		return false;
+	}
+
+	// Remote players are moved by their server moves, not by our tick
+	if (CharacterOwner->IsPlayerControlled() && !CharacterOwner->IsLocallyControlled())
+	{
+		return false;
+	}
+
+	if (!Velocity.IsZero() || !Acceleration.IsZero() || !PendingInputVector.IsZero() || bHasRequestedVelocity
+		|| !PendingLaunchVelocity.IsZero() || !PendingImpulseToApply.IsZero() || !PendingForceToApply.IsZero())
+	{
+		return false;
+	}
+
+	if (bJustTeleported || CharacterOwner->bPressedJump || HasRootMotionSources() || HasAnimRootMotion() || CharacterOwner->IsPlayingRootMotion())
+	{
+		return false;
+	}
+
+	// Still turning toward the gravity or the floor
+	if (!FHynmersOrientationSolver::ComputeDeltaRotation(UpdatedComponent->GetUpVector(), GetTargetUpVector(), PI).Equals(FQuat::Identity, KINDA_SMALL_NUMBER))
+	{
+		return false;
+	}
+
+	const UPrimitiveComponent* MovementBase = GetMovementBase();
+	return MovementBase && !MovementBaseUtility::IsDynamicBase(MovementBase);
+}
+
+bool UHynmersMovementComponent::ShouldWakeUp() const
+{
+	if (!HasValidData() || !IsMovingOnGround())
+	{
+		return true;
+	}
+
+	// Input, path following or external velocity changes
+	if (!PendingInputVector.IsZero() || !Velocity.IsZero() || bHasRequestedVelocity || CharacterOwner->bPressedJump
+		|| !PendingLaunchVelocity.IsZero() || !PendingImpulseToApply.IsZero() || !PendingForceToApply.IsZero()
+		|| HasRootMotionSources() || CharacterOwner->IsPlayingRootMotion())
+	{
+		return true;
+	}
+
+	// Moved outside of the movement component
+	if (UpdatedComponent->GetComponentLocation() != LastUpdateLocation || UpdatedComponent->GetComponentQuat() != LastUpdateRotation)
+	{
+		return true;
+	}
+
+	// Gravity field changed, the character has to turn toward it. Queries are shared per cell, this stays cheap.
+	if (bUseGravityField)
+	{
+		AHynmersGravityManager* GravityManager = AHynmersGravityManager::Find(GetWorld());
+		FVector FieldGravity;
+		const bool bHasGravity = GravityManager && GravityManager->QueryGravity(UpdatedComponent->GetComponentLocation(), FieldGravity);
+		if (bHasGravity != bSleepHasFieldGravity || (bHasGravity && !FieldGravity.GetSafeNormal().Equals(SleepGravityDirection, KINDA_SMALL_NUMBER)))
+		{
+			return true;
+		}
+	}
+
+	// Base changed or moved
+	const UPrimitiveComponent* MovementBase = GetMovementBase();
+	if (MovementBase != SleepBase.Get() || !MovementBase)
+	{
+		return true;
+	}
+	return MovementBase->GetComponentLocation() != SleepBaseLocation || MovementBase->GetComponentQuat() != SleepBaseQuat;
+}
+
+void UHynmersMovementComponent::GoToSleep()
+{
+	if (bIsSleeping)
+	{
+		return;
+	}
+
+	bIsSleeping = true;
+	IdleTime = 0.f;
+
+	UPrimitiveComponent* MovementBase = GetMovementBase();
+	SleepBase = MovementBase;
+	SleepBaseLocation = MovementBase ? MovementBase->GetComponentLocation() : FVector::ZeroVector;
+	SleepBaseQuat = MovementBase ? MovementBase->GetComponentQuat() : FQuat::Identity;
+	bSleepHasFieldGravity = bHasFieldGravity;
+	SleepGravityDirection = bHasFieldGravity ? GravityDirection : FVector::ZeroVector;
+
+	--NumAwakeCharacters;
+	++NumSleepingCharacters;
+	DEC_DWORD_STAT(STAT_HynmersAwakeCharacters);
+	INC_DWORD_STAT(STAT_HynmersSleepingCharacters);
+}
+
+void UHynmersMovementComponent::WakeUp()
+{
+	IdleTime = 0.f;
+
+	if (!bIsSleeping)
+	{
+		return;
+	}
+
+	bIsSleeping = false;
+	bForceNextFloorCheck = true;
+
+	--NumSleepingCharacters;
+	++NumAwakeCharacters;
+	DEC_DWORD_STAT(STAT_HynmersSleepingCharacters);
+	INC_DWORD_STAT(STAT_HynmersAwakeCharacters);
+}
+
+void UHynmersMovementComponent::Launch(FVector const& LaunchVel)
+{
+	WakeUp();
+	Super::Launch(LaunchVel);
+}
+
+void UHynmersMovementComponent::AddImpulse(FVector Impulse, bool bVelocityChange)
+{
+	WakeUp();
+	Super::AddImpulse(Impulse, bVelocityChange);
+}
+
+void UHynmersMovementComponent::AddForce(FVector Force)
+{
+	WakeUp();
+	Super::AddForce(Force);
+}
+
+void UHynmersMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	WakeUp();
+	MovementTrace.Record(EHynmersTraceEvent::ModeChange, MovementMode, Velocity, 0.f, PreviousMovementMode);
+	if (IsMovingOnGround())
+	{
+		LastWaterBody.Reset();
+	}
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+}
+
+void UHynmersMovementComponent::OnUpdatedComponentBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	WakeUp();
+}
+
+void UHynmersMovementComponent::SetMovementTickTier(EHynmersMovementTickTier NewTier)
+{
+	if (MovementTickTier != NewTier)
+	{
+		MovementTickTier = NewTier;
+		if (NewTier == EHynmersMovementTickTier::Full && !ExtrapolatedMeshOffset.IsZero())
+		{
+			// Next tick simulates, with whatever time was accumulated. ConsumeTickBudget only resets a non zero offset.
+			ExtrapolatedMeshOffset = FVector::ZeroVector;
+			SetMeshVisualOffset(FVector::ZeroVector);
+		}
+	}
+}
+
+bool UHynmersMovementComponent::ConsumeTickBudget(float& InOutDeltaTime)
+{
+	// Simulated proxies only smooth, they own the mesh offset
+	if (CharacterOwner && CharacterOwner->Role == ROLE_SimulatedProxy)
+	{
+		AccumulatedDeltaTime = 0.f;
+		NumPendingFixedSteps = 0;
+		return true;
+	}
+
+	AccumulatedDeltaTime += InOutDeltaTime;
+
+	int32 FrameInterval = 1;
+	switch (MovementTickTier)
+	{
+	case EHynmersMovementTickTier::Half: FrameInterval = 2; break;
+	case EHynmersMovementTickTier::Quarter: FrameInterval = 4; break;
+	case EHynmersMovementTickTier::ExtrapolateOnly: FrameInterval = 16; break;
+	default: break;
+	}
+
+	// Stagger reduced tiers so they don't all simulate the same frame, and never accumulate more than a full simulation can consume
+	const bool bSimulate = FrameInterval == 1
+		|| ((GFrameCounter + GetUniqueID()) % FrameInterval) == 0
+		|| AccumulatedDeltaTime >= MaxSimulationTimeStep * MaxSimulationIterations;
+
+	if (!bSimulate)
+	{
+		// Extrapolate the mesh along the surface with the last velocity
+		const FVector TangentVelocity = HynmersTangentMath::ProjectOnPlane(Velocity, UpVector);
+		ExtrapolatedMeshOffset += TangentVelocity * InOutDeltaTime;
+		SetMeshVisualOffset(ExtrapolatedMeshOffset);
+		return false;
+	}
+
+	if (!ExtrapolatedMeshOffset.IsZero())
+	{
+		ExtrapolatedMeshOffset = FVector::ZeroVector;
+		SetMeshVisualOffset(FVector::ZeroVector);
+	}
+
+	InOutDeltaTime = AccumulatedDeltaTime;
+	AccumulatedDeltaTime = 0.f;
+
+	// Fixed steps only at full rate, reduced tiers are already decoupled from the frame rate
+	NumPendingFixedSteps = 0;
+	if (bUseFixedTimestep && MovementTickTier == EHynmersMovementTickTier::Full)
+	{
+		FixedTimeAccumulator += InOutDeltaTime;
+
+		const int32 NumSteps = FMath::Min(FMath::FloorToInt(FixedTimeAccumulator / FixedTimestep), MaxFixedSteps);
+		FixedTimeAccumulator = FMath::Min(FixedTimeAccumulator - NumSteps * FixedTimestep, FixedTimestep);
+
+		if (NumSteps == 0)
+		{
+			ApplyFixedStepInterpolation();
+			return false;
+		}
+
+		NumPendingFixedSteps = NumSteps;
+		InOutDeltaTime = NumSteps * FixedTimestep;
+	}
+	else
+	{
+		FixedTimeAccumulator = 0.f;
+		if (bHasPreviousSimState)
+		{
+			// Leaving fixed steps, drop the interpolation offset still on the mesh
+			SetMeshVisualOffset(FVector::ZeroVector);
+			bHasPreviousSimState = false;
+		}
+	}
+
+	return true;
+}
+
+void UHynmersMovementComponent::ApplyFixedStepInterpolation()
+{
+	if (!UpdatedComponent)
+	{
+		return;
+	}
+
+	const FVector CurrentLocation = UpdatedComponent->GetComponentLocation();
+	const FQuat CurrentQuat = UpdatedComponent->GetComponentQuat();
+	if (!bHasPreviousSimState)
+	{
+		PreviousSimLocation = CurrentLocation;
+		PreviousSimQuat = CurrentQuat;
+		bHasPreviousSimState = true;
+	}
+
+	// The mesh renders one step behind the simulation, Slerp keeps the rotation around the custom up vector
+	const float Alpha = FMath::Clamp(FixedTimeAccumulator / FixedTimestep, 0.f, 1.f);
+	const FVector RenderLocation = FMath::Lerp(PreviousSimLocation, CurrentLocation, Alpha);
+	const FQuat RenderQuat = FQuat::Slerp(PreviousSimQuat, CurrentQuat, Alpha);
+
+	SetMeshVisualOffset(RenderLocation - CurrentLocation, RenderQuat * CurrentQuat.Inverse());
+}
+
+void UHynmersMovementComponent::SetMeshVisualOffset(const FVector& WorldOffset, const FQuat& WorldRotationOffset)
+{
+	USkeletalMeshComponent* Mesh = CharacterOwner ? CharacterOwner->GetMesh() : nullptr;
+	if (!Mesh || !UpdatedComponent || Mesh->GetAttachParent() != UpdatedComponent)
+	{
+		return;
+	}
+
+	const FQuat ComponentQuat = UpdatedComponent->GetComponentQuat();
+	const FQuat LocalRotationOffset = ComponentQuat.Inverse() * WorldRotationOffset * ComponentQuat;
+	const FVector LocalOffset = ComponentQuat.UnrotateVector(WorldOffset);
+
+	Mesh->SetRelativeLocationAndRotation(LocalRotationOffset.RotateVector(CharacterOwner->GetBaseTranslationOffset()) + LocalOffset,
+		LocalRotationOffset * CharacterOwner->GetBaseRotationOffset());
+}
+
+FNetworkPredictionData_Client* UHynmersMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		UHynmersMovementComponent* MutableThis = const_cast<UHynmersMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Hynmers(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void UHynmersMovementComponent::CallServerMove(const FSavedMove_Character* NewMove, const FSavedMove_Character* OldMove)
+{
+	check(NewMove != nullptr);
+
+	AHynmersCharacter* HynmersOwner = Cast<AHynmersCharacter>(CharacterOwner);
+	if (!HynmersOwner)
+	{
+		Super::CallServerMove(NewMove, OldMove);
+		return;
+	}
+
+	const uint32 ClientYawPitchINT = PackYawAndPitchTo32(NewMove->SavedControlRotation.Yaw, NewMove->SavedControlRotation.Pitch);
+	const uint8 ClientRollBYTE = FRotator::CompressAxisToByte(NewMove->SavedControlRotation.Roll);
+
+	UPrimitiveComponent* ClientMovementBase = NewMove->EndBase.Get();
+	const FName ClientBaseBone = NewMove->EndBoneName;
+	const FVector SendLocation = MovementBaseUtility::UseRelativeLocation(ClientMovementBase) ? NewMove->SavedRelativeLocation : NewMove->SavedLocation;
+
+	// Every saved move simulated with the decoded acceleration, see FSavedMove_Hynmers::SetMoveFor
+	auto PackAcceleration = [](const FSavedMove_Character* Move)
+	{
+		FHynmersPackedAcceleration PackedAccel;
+		PackedAccel.Pack(Move->Acceleration, static_cast<const FSavedMove_Hynmers*>(Move)->SavedUpVector);
+		return PackedAccel;
+	};
+
+	if (OldMove)
+	{
+		HynmersOwner->ServerMoveOldPacked(OldMove->TimeStamp, PackAcceleration(OldMove), OldMove->GetCompressedFlags());
+	}
+
+	FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+	const FSavedMove_Character* PendingMove = ClientData ? ClientData->PendingMove.Get() : nullptr;
+	if (PendingMove)
+	{
+		const uint32 OldClientYawPitchINT = PackYawAndPitchTo32(PendingMove->SavedControlRotation.Yaw, PendingMove->SavedControlRotation.Pitch);
+
+		// A delayed move without root motion followed by one with root motion, the server handles them apart
+		if (PendingMove->RootMotionMontage == nullptr && NewMove->RootMotionMontage != nullptr)
+		{
+			HynmersOwner->ServerMoveDualHybridRootMotionPacked(PendingMove->TimeStamp, PackAcceleration(PendingMove), PendingMove->GetCompressedFlags(), OldClientYawPitchINT,
+				NewMove->TimeStamp, PackAcceleration(NewMove), SendLocation, NewMove->GetCompressedFlags(), ClientRollBYTE, ClientYawPitchINT, ClientMovementBase, ClientBaseBone, NewMove->MovementMode);
+		}
+		else
+		{
+			HynmersOwner->ServerMoveDualPacked(PendingMove->TimeStamp, PackAcceleration(PendingMove), PendingMove->GetCompressedFlags(), OldClientYawPitchINT,
+				NewMove->TimeStamp, PackAcceleration(NewMove), SendLocation, NewMove->GetCompressedFlags(), ClientRollBYTE, ClientYawPitchINT, ClientMovementBase, ClientBaseBone, NewMove->MovementMode);
+		}
+	}
+	else
+	{
+		HynmersOwner->ServerMovePacked(NewMove->TimeStamp, PackAcceleration(NewMove), SendLocation, NewMove->GetCompressedFlags(), ClientRollBYTE, ClientYawPitchINT, ClientMovementBase, ClientBaseBone, NewMove->MovementMode);
+	}
+
+	MarkForClientCameraUpdate();
+}
+
+void FSavedMove_Hynmers::Clear()
+{
+	Super::Clear();
+
+	SavedUpVector = FVector::UpVector;
+	SavedStartQuat = FQuat::Identity;
+	SavedEndQuat = FQuat::Identity;
+	bStartRecorded = false;
+}
+
+void FSavedMove_Hynmers::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	const UHynmersMovementComponent* MovementComponent = Cast<UHynmersMovementComponent>(C->GetCharacterMovement());
+	if (MovementComponent && MovementComponent->UpdatedComponent)
+	{
+		SavedUpVector = MovementComponent->UpVector;
+		SavedStartQuat = MovementComponent->UpdatedComponent->GetComponentQuat();
+		SavedEndQuat = SavedStartQuat;
+		bStartRecorded = true;
+
+		// Simulate with the acceleration the server will decode
+		FHynmersPackedAcceleration PackedAccel;
+		PackedAccel.Pack(Acceleration, SavedUpVector);
+		Acceleration = PackedAccel.Unpack();
+	}
+}
+
+void FSavedMove_Hynmers::SetInitialPosition(ACharacter* C)
+{
+	Super::SetInitialPosition(C);
+
+	if (!bStartRecorded)
+	{
+		return;
+	}
+
+	// Combined with the pending move, the character was reverted to where that move started and replays start from its orientation.
+	// The up vector stays the one the acceleration was packed with, CanCombineWith only allows parallel ones.
+	const UHynmersMovementComponent* MovementComponent = Cast<UHynmersMovementComponent>(C->GetCharacterMovement());
+	const FNetworkPredictionData_Client_Character* ClientData = MovementComponent ? MovementComponent->GetPredictionData_Client_Character() : nullptr;
+	const FSavedMove_Hynmers* PendingMove = ClientData ? static_cast<const FSavedMove_Hynmers*>(ClientData->PendingMove.Get()) : nullptr;
+	if (PendingMove && PendingMove != this)
+	{
+		SavedStartQuat = PendingMove->SavedStartQuat;
+	}
+}
+
+void FSavedMove_Hynmers::PostUpdate(ACharacter* C, EPostUpdateMode PostUpdateMode)
+{
+	Super::PostUpdate(C, PostUpdateMode);
+
+	// Floor aligned orientation at the end of the move
+	const UHynmersMovementComponent* MovementComponent = Cast<UHynmersMovementComponent>(C->GetCharacterMovement());
+	if (MovementComponent && MovementComponent->UpdatedComponent)
+	{
+		SavedEndQuat = MovementComponent->UpdatedComponent->GetComponentQuat();
+	}
+}
+
+void FSavedMove_Hynmers::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	// The server only corrects the location, replays start from the orientation recorded for the move
+	UHynmersMovementComponent* MovementComponent = Cast<UHynmersMovementComponent>(C->GetCharacterMovement());
+	if (MovementComponent && MovementComponent->UpdatedComponent && C->bClientUpdating)
+	{
+		MovementComponent->UpdatedComponent->SetWorldRotation(SavedStartQuat, false, nullptr, ETeleportType::TeleportPhysics);
+		MovementComponent->UpVector = SavedUpVector;
+		MovementComponent->ForwardVector = MovementComponent->UpdatedComponent->GetForwardVector();
+		MovementComponent->RightVector = MovementComponent->UpdatedComponent->GetRightVector();
+	}
+}
+
+bool FSavedMove_Hynmers::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_Hynmers* NewHynmersMove = static_cast<const FSavedMove_Hynmers*>(NewMove.Get());
+	if ((SavedUpVector | NewHynmersMove->SavedUpVector) < THRESH_NORMALS_ARE_PARALLEL)
+	{
+		return false;
+	}
+
+	// Rotated between the moves (correction, teleport), reverting to our start would lose it
+	if (!SavedEndQuat.Equals(NewHynmersMove->SavedStartQuat, KINDA_SMALL_NUMBER))
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+FNetworkPredictionData_Client_Hynmers::FNetworkPredictionData_Client_Hynmers(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Hynmers::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Hynmers());
+}
+
+void UHynmersMovementComponent::SmoothCorrection(const FVector& OldLocation, const FQuat& OldRotation, const FVector& NewLocation, const FQuat& NewRotation)
+{
+	if (!HasValidData() || CharacterOwner->Role != ROLE_SimulatedProxy)
+	{
+		Super::SmoothCorrection(OldLocation, OldRotation, NewLocation, NewRotation);
+		return;
+	}
+
+	ProxyTimeSinceUpdate = 0.f;
+
+	// Where the mesh is currently drawn
+	const FVector VisualLocation = OldLocation + OldRotation.RotateVector(ProxyMeshOffset);
+	const FQuat VisualRotation = ProxyRotationOffset * OldRotation;
+
+	UpdatedComponent->SetWorldLocationAndRotation(NewLocation, NewRotation, false, nullptr, ETeleportType::TeleportPhysics);
+	UpVector = UpdatedComponent->GetUpVector();
+	ForwardVector = UpdatedComponent->GetForwardVector();
+	RightVector = UpdatedComponent->GetRightVector();
+
+	const float DistSq = (VisualLocation - NewLocation).SizeSquared();
+	if (NetworkSmoothingMode == ENetworkSmoothingMode::Disabled || DistSq > FMath::Square(NetworkNoSmoothUpdateDistance))
+	{
+		ProxyMeshOffset = FVector::ZeroVector;
+		ProxyRotationOffset = FQuat::Identity;
+		bNetworkSmoothingComplete = true;
+		SetMeshVisualOffset(FVector::ZeroVector);
+		return;
+	}
+
+	ProxyMeshOffset = NewRotation.UnrotateVector(VisualLocation - NewLocation);
+	ProxyRotationOffset = VisualRotation * NewRotation.Inverse();
+	bNetworkSmoothingComplete = false;
+}
+
+void UHynmersMovementComponent::SmoothClientPosition(float DeltaSeconds)
+{
+	if (!HasValidData() || CharacterOwner->Role != ROLE_SimulatedProxy)
+	{
+		Super::SmoothClientPosition(DeltaSeconds);
+		return;
+	}
+
+	if (bNetworkSmoothingComplete)
+	{
+		return;
+	}
+
+	const float LocationAlpha = NetworkSimulatedSmoothLocationTime > SMALL_NUMBER ? FMath::Min(DeltaSeconds / NetworkSimulatedSmoothLocationTime, 1.f) : 1.f;
+	const float RotationAlpha = NetworkSimulatedSmoothRotationTime > SMALL_NUMBER ? FMath::Min(DeltaSeconds / NetworkSimulatedSmoothRotationTime, 1.f) : 1.f;
+
+	// The offset lives in capsule space, so it bends with the surface. The normal part decays faster to keep the mesh on the ground
+	ProxyMeshOffset.X *= 1.f - LocationAlpha;
+	ProxyMeshOffset.Y *= 1.f - LocationAlpha;
+	ProxyMeshOffset.Z *= 1.f - FMath::Min(2.f * LocationAlpha, 1.f);
+
+	ProxyRotationOffset = FQuat::Slerp(ProxyRotationOffset, FQuat::Identity, RotationAlpha);
+
+	if (ProxyMeshOffset.SizeSquared() < KINDA_SMALL_NUMBER && ProxyRotationOffset.Equals(FQuat::Identity, KINDA_SMALL_NUMBER))
+	{
+		ProxyMeshOffset = FVector::ZeroVector;
+		ProxyRotationOffset = FQuat::Identity;
+		bNetworkSmoothingComplete = true;
+	}
+
+	SetMeshVisualOffset(UpdatedComponent->GetComponentQuat().RotateVector(ProxyMeshOffset), ProxyRotationOffset);
+}
+
+void UHynmersMovementComponent::SimulatedProxyTick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementSimulated);
+
+	ProxyTimeSinceUpdate += DeltaTime;
+
+	if (!Velocity.IsZero() && ProxyTimeSinceUpdate <= SimulatedProxyMaxExtrapolationTime)
+	{
+		const FVector OldUpVector = UpdatedComponent->GetUpVector();
+		FVector Delta;
+
+		if (IsMovingOnGround())
+		{
+			// Walking velocity stays on the tangent plane
+			Velocity = FVector::VectorPlaneProject(Velocity, OldUpVector);
+			Delta = Velocity * DeltaTime;
+		}
+		else
+		{
+			if (IsFalling())
+			{
+				Velocity += GetGravityVector() * DeltaTime;
+			}
+			Delta = Velocity * DeltaTime;
+		}
+
+		// Swept, the proxy must not be pushed through geometry while it waits for the next update
+		FHitResult Hit(1.f);
+		SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit, ETeleportType::TeleportPhysics);
+		if (Hit.IsValidBlockingHit())
+		{
+			// Hold here until the server says where it went
+			ProxyTimeSinceUpdate = SimulatedProxyMaxExtrapolationTime;
+		}
+
+		// On curved surfaces carry the frame and the velocity along with the field
+		UpdateGravity();
+		if (IsMovingOnGround() && bHasFieldGravity)
+		{
+			const FQuat SurfaceRotation = FQuat::FindBetweenNormals(OldUpVector, -GravityDirection);
+			Velocity = SurfaceRotation.RotateVector(Velocity);
+			UpdatedComponent->SetWorldRotation(SurfaceRotation * UpdatedComponent->GetComponentQuat(), false, nullptr, ETeleportType::TeleportPhysics);
+		}
+
+		UpVector = UpdatedComponent->GetUpVector();
+		ForwardVector = UpdatedComponent->GetForwardVector();
+		RightVector = UpdatedComponent->GetRightVector();
+	}
+
+	SmoothClientPosition(DeltaTime);
+}
+
+bool UHynmersMovementComponent::MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit, ETeleportType Teleport)
+{
+	HYNMERS_COUNT(MoveComponent, STAT_HynmersMoveComponent, MovementMode);
+	return Super::MoveUpdatedComponentImpl(Delta, NewRotation, bSweep, OutHit, Teleport);
+}
@@ -4,8 +4,69 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "WorldCollision.h"
+#include "HynmersMovementCore.h"
+#include "HynmersMovementTrace.h"
 #include "HynmersMovementComponent.generated.h"
 
+UENUM(BlueprintType)
+enum class EHynmersMovementTickTier : uint8
+{
+	// Simulate every frame
+	Full,
+	// Simulate every second frame with the accumulated delta time
+	Half,
+	// Simulate every fourth frame with the accumulated delta time
+	Quarter,
+	// Simulate rarely, extrapolate the mesh in between
+	ExtrapolateOnly
+};
+
+/*
+ * Last walkable floor found on a static base, reused while the capsule stays in place.
+ */
+struct FHynmersFloorCache
+{
+	FFindFloorResult Floor;
+	FVector Location;
+	FVector UpVector;
+	TWeakObjectPtr<const UPrimitiveComponent> Base;
+	float CapsuleRadius;
+	float CapsuleHalfHeight;
+	float HeightCheckAdjust;
+	bool bValid = false;
+
+	void Invalidate() { bValid = false; }
+};
+
+/*
+ * Ledge geometry found around a blocked walking move, both sides probed together in the gravity frame.
+ * Kept while the character stays on the same static floor, with the last perch test done from it.
+ */
+struct FHynmersLedgeProbe
+{
+	enum { Left = 0, Right = 1 };
+
+	FVector Location;
+	// Left side step, the right one is its opposite
+	FVector SideDir;
+	FVector UpVector;
+	TWeakObjectPtr<const UPrimitiveComponent> Floor;
+	// Floor found past each side step, blocking hit of the side step when it hit a wall
+	FHitResult SideHits[2];
+	bool bSideWalkable[2];
+	bool bValid = false;
+
+	FVector PerchLocation;
+	float PerchRadius;
+	float PerchMaxFloorDist;
+	FFindFloorResult PerchResult;
+	bool bPerchWalkable;
+	bool bPerchValid = false;
+
+	void Invalidate() { bValid = false; bPerchValid = false; }
+};
+
 /*
  * 
  */
@@ -22,11 +83,47 @@ class MOVEMENTCOMPONENT_API UHynmersMovementComponent : public UCharacterMovemen
 public:
 
 	UHynmersMovementComponent();
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 
 	virtual void PerformMovement(float DeltaSeconds) override;
 
+	// Gravity query and input consumption done at the start of the tick
+	void PrepareMovementTick(float DeltaTime);
+
+	// Rotate the updated component toward the target up vector, done inside the scoped move of every move so replayed moves realign too
+	void UpdateOrientation(float DeltaTime);
+
+	virtual class FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	// Keeps the mesh where it was and moves the capsule to the replicated state, the offset decays in SmoothClientPosition
+	virtual void SmoothCorrection(const FVector& OldLocation, const FQuat& OldRotation, const FVector& NewLocation, const FQuat& NewRotation) override;
+
+	// Longest time a simulated proxy keeps moving along the surface without a net update, it stops earlier on a blocking hit
+	UPROPERTY(Category = "Character Movement (Networking)", EditDefaultsOnly, meta = (ClampMin = "0", UIMin = "0"))
+		float SimulatedProxyMaxExtrapolationTime = 0.25f;
+
+protected:
+	virtual void SmoothClientPosition(float DeltaSeconds) override;
+
+	// Follows the base in the gravity frame: the full base rotation is applied to the capsule and the floor is carried along
+	virtual void UpdateBasedMovement(float DeltaSeconds) override;
+
+	// Counted for the movement stats
+	virtual bool MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit = NULL, ETeleportType Teleport = ETeleportType::None) override;
+
+	// Extrapolation and smoothing of simulated proxies, without floor queries
+	void SimulatedProxyTick(float DeltaTime);
+
+	// Moves go through the packed RPCs of AHynmersCharacter, with the acceleration relative to the up vector of each move
+	virtual void CallServerMove(const class FSavedMove_Character* NewMove, const class FSavedMove_Character* OldMove) override;
+
+public:
+
 	//Movements
 	virtual void PhysWalking(float deltaTime, int32 Iterations) override;
 
@@ -37,14 +134,29 @@ public:
 
 	virtual bool ComputePerchResult(const float TestRadius, const FHitResult& InHit, const float InMaxFloorDist, FFindFloorResult& OutPerchFloorResult) const;
 
+	// Last ledge probe, reused by GetLedgeMove and ComputePerchResult
+	const FHynmersLedgeProbe& GetLedgeProbe() const { return LedgeProbe; }
+
 	// function that clamp acceleration in Z
 	virtual FVector ConstrainInputAcceleration(const FVector& InputAcceleration) const override;
 
+	// Path following velocity, kept on the tangent plane instead of world XY when on the ground or falling
+	virtual void RequestDirectMove(const FVector& MoveVelocity, bool bForceMaxSpeed) override;
+
+	// Wakes the character for path following that drives the input instead of the velocity
+	virtual void RequestPathMove(const FVector& MoveInput) override;
+
 	// Function that clamps velocity in Z
 	virtual void MaintainHorizontalGroundVelocity() override;
 
+	// Applies the avoidance solved by the movement manager when there is one, the avoidance manager otherwise
+	virtual void CalcAvoidanceVelocity(float DeltaTime) override;
+
 	virtual FVector ComputeGroundMovementDelta(const FVector& Delta, const FHitResult& RampHit, const bool bHitFromLineTrace) const;
 
+	// Current tangent frame for the HynmersMovementCore helpers
+	FHynmersMovementFrame GetMovementFrame() const;
+
 	bool SafeMoveUpdatedComponent(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult& OutHit, ETeleportType Teleport = ETeleportType::None);
 
 	bool MoveUpdatedComponent(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit = NULL, ETeleportType Teleport = ETeleportType::None);
@@ -64,13 +176,76 @@ public:
 	// Floor Finding functions
 	virtual void FindFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult, bool bZeroDelta, const FHitResult* DownwardSweepResult = NULL) const override;
 
+	// Perch validation of a floor check result, done by FindFloor when the result was not reused
+	void ValidatePerchedFloor(FFindFloorResult& OutFloorResult, float HeightCheckAdjust) const;
+
+	// Compute the floor at the current location into CurrentFloor. Only issues read-only scene queries and
+	// writes state of this component, so the movement manager runs it for every character in parallel.
+	void PrefetchFloor();
+
+	// PerformMovement runs in our own tick: locally controlled, or authority without a remote controller.
+	// Remote players on the server only move in their server moves.
+	bool IsMovedByLocalTick() const;
+
 	virtual void ComputeFloorDist(const FVector& CapsuleLocation, float LineDistance, float SweepDistance, FFindFloorResult& OutFloorResult, float SweepRadius, const FHitResult* DownwardSweepResult = NULL) const override;
 
+	// Floor from the static distance field, false when the field can not answer and a sweep is needed
+	bool ComputeFloorDistFromField(const FVector& CapsuleLocation, float SweepDistance, float SweepRadius, float PawnHalfHeight, FFindFloorResult& OutFloorResult) const;
+
 	virtual bool FloorSweepTest(struct FHitResult& OutHit, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, const struct FCollisionShape& CollisionShape,
 		const struct FCollisionQueryParams& Params, const struct FCollisionResponseParams& ResponseParam) const override;
 
 	virtual bool IsWalkable(const FHitResult& Hit) const override;
 
+	virtual void OnTeleported() override;
+
+	// Sleeping
+	virtual void Launch(FVector const& LaunchVel) override;
+
+	virtual void AddImpulse(FVector Impulse, bool bVelocityChange = false) override;
+
+	virtual void AddForce(FVector Force) override;
+
+	bool IsSleeping() const { return bIsSleeping; }
+
+	// Resume running the movement pipeline
+	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|CharacterMovement")
+		void WakeUp();
+
+	// Tick LOD, assigned by the movement manager significance pass
+	void SetMovementTickTier(EHynmersMovementTickTier NewTier);
+
+	EHynmersMovementTickTier GetMovementTickTier() const { return MovementTickTier; }
+
+	// Accumulates DeltaTime and returns true with the accumulated time if the tier simulates this frame.
+	// Otherwise the mesh is extrapolated along the tangent plane.
+	bool ConsumeTickBudget(float& InOutDeltaTime);
+
+	const FHynmersMovementTrace& GetMovementTrace() const { return MovementTrace; }
+
+	static int32 GetNumSleepingCharacters() { return NumSleepingCharacters; }
+
+	static int32 GetNumAwakeCharacters() { return NumAwakeCharacters; }
+
+	// Floor cache
+	bool GetCachedFloor(const FVector& CapsuleLocation, float HeightCheckAdjust, FFindFloorResult& OutFloorResult) const;
+
+	void CacheFloor(const FVector& CapsuleLocation, float HeightCheckAdjust, const FFindFloorResult& FloorResult) const;
+
+	void InvalidateFloorCache() { FloorCache.Invalidate(); }
+
+	// Fire the async floor sweep for the next frame, from the velocity along the surface
+	void RequestFloorPrediction(float DeltaTime);
+
+	// Floor from the async sweep of the previous frame, false if it is not usable at this location
+	bool ConsumeFloorPrediction(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult);
+
+	// Sweeps both side steps then down from the free ones, replaces the ledge probe
+	void ProbeLedges(const FVector& OldLocation, const FVector& SideDir, const FVector& GravDir) const;
+
+	// True if the ledge probe is still valid for this floor, location and up vector
+	bool IsLedgeProbeValid(const FVector& Location) const;
+
 	virtual void PhysFalling(float deltaTime, int32 Iterations) override;
 
 	virtual FVector GetFallingLateralAcceleration(float DeltaTime) override;
@@ -95,14 +270,220 @@ public:
 
 	void StartSwimming(FVector OldLocation, FVector OldVelocity, float timeTick, float remainingTime, int32 Iterations);
 
+	// Closed form for analytic water bodies, a brush trace cached while nothing moves otherwise
 	virtual float ImmersionDepth() const override;
 
+	// Closed form for analytic water bodies, including the one the character just swam out of
+	virtual FVector FindWaterLine(FVector InWater, FVector OutofWater) override;
+
+	// Gravity
+	virtual float GetGravityZ() const override;
+
+	// Gravity acceleration in world space, along the gravity field when there is one
+	FVector GetGravityVector() const;
+
+	// Up vector the updated component is realigned to
+	FVector GetTargetUpVector() const;
+
 	// Angular velocity in degrees per second
 	UPROPERTY(Category = "Character Movement: Walking", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", UIMin = "0"))
 		float AngularVelocity = 90.f;
 
+	// Take gravity from the world gravity sources instead of the floor normal when any source affects the character
+	UPROPERTY(Category = "Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite)
+		uint32 bUseGravityField : 1;
+
+	// Reuse the last floor without any query while the character stays on a static base
+	UPROPERTY(Category = "Character Movement: Walking", EditAnywhere, BlueprintReadWrite)
+		uint32 bUseFloorCache : 1;
+
+	// Capsule displacement under which a cached floor is still valid
+	UPROPERTY(Category = "Character Movement: Walking", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseFloorCache"))
+		float FloorCacheTolerance = 0.1f;
+
+	// Sweep the floor asynchronously at the location expected next frame, and use it if the character gets there
+	UPROPERTY(Category = "Character Movement: Walking", EditAnywhere, BlueprintReadWrite)
+		uint32 bUseAsyncFloorPrediction : 1;
+
+	// Distance between the predicted and actual location under which the predicted floor is used
+	UPROPERTY(Category = "Character Movement: Walking", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseAsyncFloorPrediction"))
+		float AsyncFloorPredictionTolerance = 2.f;
+
+	// Answer floor queries from the static distance field of the world when there is one and no dynamic object is around
+	UPROPERTY(Category = "Character Movement: Walking", EditAnywhere, BlueprintReadWrite)
+		uint32 bUseStaticDistanceField : 1;
+
+	// Skip the movement pipeline of characters that stay idle on a static floor
+	UPROPERTY(Category = "Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite)
+		uint32 bEnableSleeping : 1;
+
+	// Seconds a character has to be idle before it goes to sleep
+	UPROPERTY(Category = "Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", UIMin = "0", EditCondition = "bEnableSleeping"))
+		float SleepDelay = 0.5f;
+
+	// Let the world movement manager tick this component together with the rest of registered components
+	UPROPERTY(Category = "Character Movement (General Settings)", EditDefaultsOnly, BlueprintReadOnly)
+		uint32 bUseMovementManager : 1;
+
+	// Simulate in steps of FixedTimestep and interpolate the mesh between the last two simulated states
+	UPROPERTY(Category = "Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite)
+		uint32 bUseFixedTimestep : 1;
+
+	UPROPERTY(Category = "Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.001", UIMin = "0.001", EditCondition = "bUseFixedTimestep"))
+		float FixedTimestep = 1.f / 60.f;
+
+	// Steps allowed in a single frame, extra accumulated time is dropped
+	UPROPERTY(Category = "Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1", UIMin = "1", EditCondition = "bUseFixedTimestep"))
+		int32 MaxFixedSteps = 4;
+
+protected:
+	// Query the world gravity manager at the current location
+	void UpdateGravity();
+
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+
+	// True if nothing would move the character this tick
+	bool CanSleep() const;
+
+	bool ShouldWakeUp() const;
+
+	void GoToSleep();
+
+	// Place the mesh between the previous and current simulated states
+	void ApplyFixedStepInterpolation();
+
+	// Move the mesh away from the capsule, in world space
+	void SetMeshVisualOffset(const FVector& WorldOffset, const FQuat& WorldRotationOffset = FQuat::Identity);
+
+	// Not registered with the avoidance manager while the movement manager solves the avoidance
+	virtual void UpdateDefaultAvoidance() override;
+
+	UFUNCTION()
+		void OnUpdatedComponentBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
 private:
+	friend class AHynmersMovementManager;
+	friend class FSavedMove_Hynmers;
+
 	FVector UpVector;
 	FVector RightVector;
 	FVector ForwardVector;
+
+	// Tangent velocity change solved by the movement manager this frame
+	FVector AvoidanceCorrection;
+
+	bool bHasAvoidanceCorrection;
+
+	// Registered with the movement manager, which solves the avoidance instead of the UAvoidanceManager
+	bool bManagedByMovementManager;
+
+	// Gravity field result of the last UpdateGravity
+	FVector GravityDirection;
+	float GravityMagnitude;
+	bool bHasFieldGravity;
+
+	// Input consumed by PrepareMovementTick, constrained to the surface
+	FVector PendingInputVector;
+
+	// The movement manager already ran PrepareMovementTick for this tick
+	bool bMovementTickPrepared;
+
+	// Key of the floor computed by PrefetchFloor, PhysWalking reuses it if the character did not move
+	FVector PrefetchedFloorLocation;
+	FVector PrefetchedFloorUpVector;
+	bool bHasPrefetchedFloor;
+
+	// CurrentFloor was moved with its base by UpdateBasedMovement, valid until the character moves on its own
+	bool bFloorRebased;
+
+	mutable FHynmersFloorCache FloorCache;
+
+	// Water body of the last swimming update, still known once the character left it, until it lands or teleports
+	TWeakObjectPtr<const class AHynmersWaterBody> LastWaterBody;
+
+	// Pending async floor sweep, a sphere from the bottom of the shrunk capsule at the predicted location
+	FTraceHandle FloorPredictionHandle;
+	FVector PredictedFloorLocation;
+	FVector PredictedFloorUpVector;
+	// Distance from the capsule center to the swept sphere, and the sweep distances of the prediction
+	float PredictedSphereOffset;
+	float PredictedShrinkHeight;
+	float PredictedTraceDist;
+	float PredictedSweepDist;
+
+	FHynmersOrientationSolver OrientationSolver;
+
+	mutable FHynmersLedgeProbe LedgeProbe;
+
+	// Recent movement events, recorded from const queries too
+	mutable FHynmersMovementTrace MovementTrace;
+
+	bool bIsSleeping;
+	float IdleTime;
+
+	// Base state when the character went to sleep
+	TWeakObjectPtr<UPrimitiveComponent> SleepBase;
+	FVector SleepBaseLocation;
+	FQuat SleepBaseQuat;
+
+	// Gravity field when the character went to sleep
+	FVector SleepGravityDirection;
+	bool bSleepHasFieldGravity;
+
+	EHynmersMovementTickTier MovementTickTier;
+	float AccumulatedDeltaTime;
+	FVector ExtrapolatedMeshOffset;
+
+	// Simulated proxy mesh offset in capsule space and rotation offset in world space
+	FVector ProxyMeshOffset;
+	FQuat ProxyRotationOffset;
+	float ProxyTimeSinceUpdate;
+
+	float FixedTimeAccumulator;
+	int32 NumPendingFixedSteps;
+	FVector PreviousSimLocation;
+	FQuat PreviousSimQuat;
+	bool bHasPreviousSimState;
+
+	static int32 NumSleepingCharacters;
+	static int32 NumAwakeCharacters;
+};
+
+/*
+ * Saved move that also records the gravity frame, so replayed moves start from the orientation the client had.
+ */
+class MOVEMENTCOMPONENT_API FSavedMove_Hynmers : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	FVector SavedUpVector;
+	FQuat SavedStartQuat;
+	FQuat SavedEndQuat;
+
+	// Set once SetMoveFor recorded the start, a later SetInitialPosition comes from combining with the pending move
+	bool bStartRecorded = false;
+
+	virtual void Clear() override;
+
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData) override;
+
+	virtual void SetInitialPosition(ACharacter* C) override;
+
+	virtual void PostUpdate(ACharacter* C, EPostUpdateMode PostUpdateMode) override;
+
+	virtual void PrepMoveFor(ACharacter* C) override;
+
+	// Moves only combine while the up vector is stable and the new move starts in the orientation the pending one ended in
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+};
+
+class MOVEMENTCOMPONENT_API FNetworkPredictionData_Client_Hynmers : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	FNetworkPredictionData_Client_Hynmers(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
 };
@@ -0,0 +1,614 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementManager.h"
+#include "HynmersMovementComponent.h"
+#include "HynmersMovementCore.h"
+#include "HynmersMovementStats.h"
+#include "HynmersStaticDistanceField.h"
+#include "HynmersTangentMath.h"
+
+#include "AI/Navigation/AvoidanceManager.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Physics/PhysScene.h"
+#if WITH_PHYSX
+#include "PhysXPublic.h"
+#endif
+
+DECLARE_CYCLE_STAT(TEXT("Hynmers Movement Manager Tick"), STAT_HynmersMovementManagerTick, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Hynmers Movement Batch Math"), STAT_HynmersMovementBatchMath, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Hynmers Movement Significance"), STAT_HynmersMovementSignificance, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Hynmers Movement Parallel FindFloor"), STAT_HynmersMovementParallelFloor, STATGROUP_HynmersMovement);
+DECLARE_CYCLE_STAT(TEXT("Hynmers Movement Avoidance"), STAT_HynmersMovementAvoidance, STATGROUP_HynmersMovement);
+
+static TAutoConsoleVariable<int32> CVarHynmersParallelFloorQueries(
+	TEXT("Hynmers.ParallelFloorQueries"),
+	1,
+	TEXT("Issue the floor queries of every character registered in the movement manager in parallel before movement.\n")
+	TEXT("0: Each character finds its floor during its own movement, 1: Parallel floor phase"),
+	ECVF_Default);
+
+namespace HynmersMovement
+{
+	static TMap<TWeakObjectPtr<const UWorld>, TWeakObjectPtr<AHynmersMovementManager>> WorldManagers;
+}
+
+void FHynmersMovementBatch::Reset(int32 Num)
+{
+	InputAcceleration.SetNumUninitialized(Num, false);
+	UpVector.SetNumUninitialized(Num, false);
+	RightVector.SetNumUninitialized(Num, false);
+	ForwardVector.SetNumUninitialized(Num, false);
+	MovementMode.SetNumUninitialized(Num, false);
+	FloorDist.SetNumUninitialized(Num, false);
+	DeltaTime.SetNumZeroed(Num, false);
+	bActive.SetNumZeroed(Num, false);
+	Mask.SetNumZeroed(Num, false);
+}
+
+AHynmersMovementManager::AHynmersMovementManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+	bReplicates = false;
+}
+
+void AHynmersMovementManager::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	HynmersMovement::WorldManagers.Add(GetWorld(), this);
+}
+
+void AHynmersMovementManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	const TWeakObjectPtr<AHynmersMovementManager>* Registered = HynmersMovement::WorldManagers.Find(GetWorld());
+	if (Registered && Registered->Get() == this)
+	{
+		HynmersMovement::WorldManagers.Remove(GetWorld());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+AHynmersMovementManager* AHynmersMovementManager::Find(const UWorld* World)
+{
+	const TWeakObjectPtr<AHynmersMovementManager>* Registered = World ? HynmersMovement::WorldManagers.Find(World) : nullptr;
+	return Registered ? Registered->Get() : nullptr;
+}
+
+AHynmersMovementManager* AHynmersMovementManager::FindOrSpawn(UWorld* World)
+{
+	AHynmersMovementManager* Manager = Find(World);
+	if (!Manager && World && World->IsGameWorld())
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		Manager = World->SpawnActor<AHynmersMovementManager>(SpawnParams);
+	}
+	return Manager;
+}
+
+void AHynmersMovementManager::RegisterComponent(UHynmersMovementComponent* Component)
+{
+	for (const FRegisteredComponent& Registered : Components)
+	{
+		if (Registered.Component == Component)
+		{
+			return;
+		}
+	}
+
+	const int32 Index = Components.AddDefaulted();
+	Components[Index].Component = Component;
+
+	// The manager solves the avoidance from now on, drop the entry added when the updated component was set
+	Component->bManagedByMovementManager = true;
+	if (UAvoidanceManager* AvoidanceManager = GetWorld()->GetAvoidanceManager())
+	{
+		AvoidanceManager->RemoveAvoidanceObject(Component->AvoidanceUID);
+	}
+
+	Component->SetComponentTickEnabled(false);
+	UpdateTickPrerequisites(Index);
+}
+
+void AHynmersMovementManager::UnregisterComponent(UHynmersMovementComponent* Component)
+{
+	for (int32 i = 0; i < Components.Num(); ++i)
+	{
+		if (Components[i].Component == Component)
+		{
+			if (AController* Controller = Components[i].Controller.Get())
+			{
+				PrimaryActorTick.RemovePrerequisite(Controller, Controller->PrimaryActorTick);
+			}
+			Components.RemoveAtSwap(i);
+			Component->bManagedByMovementManager = false;
+			Component->bHasAvoidanceCorrection = false;
+			return;
+		}
+	}
+}
+
+void AHynmersMovementManager::UpdateTickPrerequisites(int32 Index)
+{
+	FRegisteredComponent& Registered = Components[Index];
+	const UHynmersMovementComponent* Component = Registered.Component.Get();
+	AController* Controller = (Component && Component->GetCharacterOwner()) ? Component->GetCharacterOwner()->Controller : nullptr;
+
+	if (Registered.Controller.Get() != Controller)
+	{
+		if (AController* OldController = Registered.Controller.Get())
+		{
+			PrimaryActorTick.RemovePrerequisite(OldController, OldController->PrimaryActorTick);
+		}
+		if (Controller)
+		{
+			// Same dependency AController::AddPawnTickDependency gives the component tick
+			PrimaryActorTick.AddPrerequisite(Controller, Controller->PrimaryActorTick);
+		}
+		Registered.Controller = Controller;
+	}
+}
+
+void AHynmersMovementManager::Tick(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HynmersMovementManagerTick);
+
+	Super::Tick(DeltaSeconds);
+
+	for (int32 i = Components.Num() - 1; i >= 0; --i)
+	{
+		if (!Components[i].Component.IsValid())
+		{
+			Components.RemoveAtSwap(i);
+		}
+	}
+
+	UpdateSignificance(DeltaSeconds);
+
+	Batch.Reset(Components.Num());
+
+	// Orientation and input, per component
+	for (int32 i = 0; i < Components.Num(); ++i)
+	{
+		UpdateTickPrerequisites(i);
+
+		UHynmersMovementComponent* Component = Components[i].Component.Get();
+		if (Component->IsActive() && Component->UpdatedComponent)
+		{
+			const AActor* Owner = Component->GetOwner();
+			float ComponentDeltaTime = DeltaSeconds * (Owner ? Owner->CustomTimeDilation : 1.f);
+			if (!Component->ConsumeTickBudget(ComponentDeltaTime))
+			{
+				continue;
+			}
+
+			Component->PrepareMovementTick(ComponentDeltaTime);
+			Batch.DeltaTime[i] = ComponentDeltaTime;
+			Batch.bActive[i] = !Component->IsSleeping();
+		}
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HynmersMovementBatchMath);
+
+		GatherBatch();
+		ConstrainInputAccelerationBatch();
+		ScatterBatch();
+	}
+
+	SolveAvoidanceBatch(DeltaSeconds);
+
+	// Floor queries answered by the distance field check the movables without the physics scene
+	if (AHynmersStaticDistanceField* Field = AHynmersStaticDistanceField::Find(GetWorld()))
+	{
+		Field->UpdateMovables();
+	}
+
+	if (CVarHynmersParallelFloorQueries.GetValueOnGameThread() != 0)
+	{
+		PrefetchFloorsParallel();
+	}
+
+	UpdateMovementBases();
+
+	// Collision phase
+	for (int32 i : TickOrder)
+	{
+		UHynmersMovementComponent* Component = Components[i].Component.Get();
+		if (Batch.bActive[i] && Component)
+		{
+			Component->bMovementTickPrepared = true;
+			Component->TickComponent(Batch.DeltaTime[i], LEVELTICK_All, &Component->PrimaryComponentTick);
+		}
+	}
+}
+
+void AHynmersMovementManager::UpdateMovementBases()
+{
+	const int32 NumComponents = Components.Num();
+	TickOrder.Reset(NumComponents);
+
+	TArray<UPrimitiveComponent*, TInlineAllocator<64>> Bases;
+	Bases.SetNumZeroed(NumComponents);
+	bool bAnyBase = false;
+	for (int32 i = 0; i < NumComponents; ++i)
+	{
+		const ACharacter* Character = Components[i].Component->GetCharacterOwner();
+		UPrimitiveComponent* Base = Character ? Character->GetMovementBase() : nullptr;
+		if (MovementBaseUtility::UseRelativeLocation(Base) && Base->GetOwner())
+		{
+			Bases[i] = Base;
+			bAnyBase = true;
+		}
+	}
+
+	TSet<TWeakObjectPtr<UPrimitiveComponent>> NewDependencies;
+	if (!bAnyBase)
+	{
+		for (int32 i = 0; i < NumComponents; ++i)
+		{
+			TickOrder.Add(i);
+		}
+	}
+	else
+	{
+		TMap<const AActor*, int32> OwnerIndices;
+		OwnerIndices.Reserve(NumComponents);
+		for (int32 i = 0; i < NumComponents; ++i)
+		{
+			OwnerIndices.Add(Components[i].Component->GetOwner(), i);
+		}
+
+		// Walk each chain of bases down to its root and add it root first
+		TBitArray<> Visited(false, NumComponents);
+		TArray<int32, TInlineAllocator<8>> Chain;
+		for (int32 i = 0; i < NumComponents; ++i)
+		{
+			Chain.Reset();
+			for (int32 j = i; j != INDEX_NONE && !Visited[j];)
+			{
+				Visited[j] = true;
+				Chain.Add(j);
+
+				const int32* BaseIndex = Bases[j] ? OwnerIndices.Find(Bases[j]->GetOwner()) : nullptr;
+				if (Bases[j] && !BaseIndex)
+				{
+					NewDependencies.Add(Bases[j]);
+				}
+				j = BaseIndex ? *BaseIndex : INDEX_NONE;
+			}
+
+			for (int32 k = Chain.Num() - 1; k >= 0; --k)
+			{
+				TickOrder.Add(Chain[k]);
+			}
+		}
+	}
+
+	// Bases ticked by the world, such as platforms and movers. Applies from the next frame.
+	for (const TWeakObjectPtr<UPrimitiveComponent>& Base : BaseTickDependencies)
+	{
+		if (Base.IsValid() && !NewDependencies.Contains(Base))
+		{
+			MovementBaseUtility::RemoveTickDependency(PrimaryActorTick, Base.Get());
+		}
+	}
+	for (const TWeakObjectPtr<UPrimitiveComponent>& Base : NewDependencies)
+	{
+		if (!BaseTickDependencies.Contains(Base))
+		{
+			MovementBaseUtility::AddTickDependency(PrimaryActorTick, Base.Get());
+		}
+	}
+	BaseTickDependencies = MoveTemp(NewDependencies);
+}
+
+void AHynmersMovementManager::UpdateSignificance(float DeltaSeconds)
+{
+	TimeSinceSignificanceUpdate += DeltaSeconds;
+	if (TimeSinceSignificanceUpdate < SignificanceUpdateInterval)
+	{
+		return;
+	}
+	TimeSinceSignificanceUpdate = 0.f;
+
+	SCOPE_CYCLE_COUNTER(STAT_HynmersMovementSignificance);
+
+	TArray<FVector, TInlineAllocator<16>> ViewLocations;
+	if (bEnableMovementLOD)
+	{
+		for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+		{
+			if (const APlayerController* PlayerController = Iterator->Get())
+			{
+				FVector ViewLocation;
+				FRotator ViewRotation;
+				PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+				ViewLocations.Add(ViewLocation);
+			}
+		}
+	}
+
+	const bool bCheckRendered = GetNetMode() != NM_DedicatedServer;
+	for (const FRegisteredComponent& Registered : Components)
+	{
+		UHynmersMovementComponent* Component = Registered.Component.Get();
+		const ACharacter* Character = Component ? Component->GetCharacterOwner() : nullptr;
+		if (!Character)
+		{
+			continue;
+		}
+
+		// Without viewers there is nothing to rank against, players always simulate at full rate and proxies only smooth
+		if (ViewLocations.Num() == 0 || Character->IsPlayerControlled() || Character->Role == ROLE_SimulatedProxy || !Component->UpdatedComponent)
+		{
+			Component->SetMovementTickTier(EHynmersMovementTickTier::Full);
+			continue;
+		}
+
+		const FVector Location = Component->UpdatedComponent->GetComponentLocation();
+		float ClosestDistSq = MAX_flt;
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			ClosestDistSq = FMath::Min(ClosestDistSq, FVector::DistSquared(Location, ViewLocation));
+		}
+
+		int32 Tier = 0;
+		if (ClosestDistSq >= FMath::Square(ExtrapolateOnlyDistance))
+		{
+			Tier = (int32)EHynmersMovementTickTier::ExtrapolateOnly;
+		}
+		else if (ClosestDistSq >= FMath::Square(QuarterRateDistance))
+		{
+			Tier = (int32)EHynmersMovementTickTier::Quarter;
+		}
+		else if (ClosestDistSq >= FMath::Square(HalfRateDistance))
+		{
+			Tier = (int32)EHynmersMovementTickTier::Half;
+		}
+
+		// Nothing is rendered on a dedicated server, only the distance counts there
+		const USkeletalMeshComponent* Mesh = Character->GetMesh();
+		if (bCheckRendered && Mesh && !Mesh->WasRecentlyRendered(RecentlyRenderedTolerance))
+		{
+			Tier = FMath::Min(Tier + 1, (int32)EHynmersMovementTickTier::ExtrapolateOnly);
+		}
+
+		Component->SetMovementTickTier((EHynmersMovementTickTier)Tier);
+	}
+}
+
+void AHynmersMovementManager::PrefetchFloorsParallel()
+{
+	SCOPE_CYCLE_COUNTER(STAT_HynmersMovementParallelFloor);
+
+	TArray<UHynmersMovementComponent*, TInlineAllocator<256>> Walking;
+	for (int32 i = 0; i < Components.Num(); ++i)
+	{
+		const uint8 Mode = Batch.MovementMode[i];
+		if (!Batch.bActive[i] || (Mode != MOVE_Walking && Mode != MOVE_NavWalking))
+		{
+			continue;
+		}
+
+		// Simulated proxies are smoothed without floor queries, a prefetched floor would never be read.
+		// Remote players only move in ServerMove, prefetching would change the floor their next move starts from.
+		UHynmersMovementComponent* Component = Components[i].Component.Get();
+		if (Component->CharacterOwner && Component->CharacterOwner->Role != ROLE_SimulatedProxy && Component->IsMovedByLocalTick())
+		{
+			Walking.Add(Component);
+		}
+	}
+
+	if (Walking.Num() == 0)
+	{
+		return;
+	}
+
+#if WITH_PHYSX
+	// One read lock for the whole phase, the queries on the worker threads only read the scene
+	FPhysScene* PhysScene = GetWorld()->GetPhysicsScene();
+	SCOPED_SCENE_READ_LOCK(PhysScene ? PhysScene->GetPhysXScene(PST_Sync) : nullptr);
+#endif
+
+	ParallelFor(Walking.Num(), [&Walking](int32 Index)
+	{
+		Walking[Index]->PrefetchFloor();
+	});
+}
+
+void AHynmersMovementManager::GatherBatch()
+{
+	for (int32 i = 0; i < Components.Num(); ++i)
+	{
+		if (!Batch.bActive[i])
+		{
+			continue;
+		}
+
+		const UHynmersMovementComponent* Component = Components[i].Component.Get();
+		Batch.InputAcceleration[i] = Component->PendingInputVector;
+		Batch.UpVector[i] = Component->UpVector;
+		Batch.RightVector[i] = Component->RightVector;
+		Batch.ForwardVector[i] = Component->ForwardVector;
+		Batch.MovementMode[i] = Component->MovementMode;
+		Batch.FloorDist[i] = Component->CurrentFloor.FloorDist;
+	}
+}
+
+void AHynmersMovementManager::ConstrainInputAccelerationBatch()
+{
+	// Same as UHynmersMovementComponent::ConstrainInputAcceleration
+	const int32 Num = Components.Num();
+	for (int32 i = 0; i < Num; ++i)
+	{
+		const uint8 Mode = Batch.MovementMode[i];
+		Batch.Mask[i] = Batch.bActive[i] && (Mode == MOVE_Walking || Mode == MOVE_NavWalking || Mode == MOVE_Falling);
+	}
+	HynmersTangentMath::ProjectOnPlaneBatch(Batch.InputAcceleration.GetData(), Batch.UpVector.GetData(), Batch.Mask.GetData(), Num);
+}
+
+void AHynmersMovementManager::ScatterBatch()
+{
+	for (int32 i = 0; i < Components.Num(); ++i)
+	{
+		if (!Batch.bActive[i])
+		{
+			continue;
+		}
+
+		UHynmersMovementComponent* Component = Components[i].Component.Get();
+		Component->PendingInputVector = Batch.InputAcceleration[i];
+	}
+}
+
+void AHynmersMovementManager::SolveAvoidanceBatch(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HynmersMovementAvoidance);
+
+	AvoidanceAgents.Reset();
+	AvoidanceHash.Reset();
+
+	int32 NumSolved = 0;
+	for (int32 i = 0; i < Components.Num(); ++i)
+	{
+		UHynmersMovementComponent* Component = Components[i].Component.Get();
+		const ACharacter* Character = Component ? Component->GetCharacterOwner() : nullptr;
+		if (!Character || !Component->bUseRVOAvoidance || !Component->UpdatedComponent)
+		{
+			continue;
+		}
+
+		const int32 AgentIndex = AvoidanceAgents.AddUninitialized();
+		FHynmersAvoidanceAgent& Agent = AvoidanceAgents[AgentIndex];
+		Agent.Location = Component->UpdatedComponent->GetComponentLocation();
+		Agent.Velocity = Component->Velocity;
+		Agent.UpVector = Component->UpVector;
+		Agent.RightVector = Component->RightVector;
+		Agent.ForwardVector = Component->ForwardVector;
+		Character->GetCapsuleComponent()->GetScaledCapsuleSize(Agent.Radius, Agent.HalfHeight);
+		Agent.MaxSpeed = Component->GetMaxSpeed();
+		Agent.ConsiderationRadius = Component->AvoidanceConsiderationRadius;
+		Agent.Weight = Component->AvoidanceWeight;
+		Agent.GroupMask = Component->GetAvoidanceGroupMask();
+		Agent.GroupsToAvoid = Component->GetGroupsToAvoidMask();
+		Agent.GroupsToIgnore = Component->GetGroupsToIgnoreMask();
+		Agent.Component = i;
+		// Same conditions as UCharacterMovementComponent::CalcAvoidanceVelocity, a weight of 1 never gives way
+		Agent.bSolve = Batch.bActive[i] && Character->Role == ROLE_Authority && Agent.Weight < 1.f
+			&& (Component->IsMovingOnGround() || Component->IsFalling()) && !HynmersTangentMath::ProjectOnPlane(Agent.Velocity, Agent.UpVector).IsNearlyZero();
+		Agent.AvoidanceVelocity = Agent.Velocity;
+		NumSolved += Agent.bSolve ? 1 : 0;
+
+		const FVector Cell = Agent.Location / AvoidanceCellSize;
+		AvoidanceHash.FindOrAdd(FIntVector(FMath::FloorToInt(Cell.X), FMath::FloorToInt(Cell.Y), FMath::FloorToInt(Cell.Z))).Add(AgentIndex);
+	}
+
+	if (NumSolved == 0)
+	{
+		return;
+	}
+
+	// Agents only write their own result
+	ParallelFor(AvoidanceAgents.Num(), [this, DeltaSeconds](int32 AgentIndex)
+	{
+		if (AvoidanceAgents[AgentIndex].bSolve)
+		{
+			SolveAvoidance(AgentIndex, DeltaSeconds);
+		}
+	});
+
+	for (const FHynmersAvoidanceAgent& Agent : AvoidanceAgents)
+	{
+		if (Agent.bSolve)
+		{
+			UHynmersMovementComponent* Component = Components[Agent.Component].Component.Get();
+			// Applied as a correction, the component velocity changed since it was gathered
+			Component->AvoidanceCorrection = Agent.AvoidanceVelocity - HynmersTangentMath::ProjectOnPlane(Agent.Velocity, Agent.UpVector);
+			Component->bHasAvoidanceCorrection = true;
+		}
+	}
+}
+
+void AHynmersMovementManager::SolveAvoidance(int32 AgentIndex, float DeltaSeconds)
+{
+	FHynmersAvoidanceAgent& Agent = AvoidanceAgents[AgentIndex];
+
+	TArray<TPair<float, int32>, TInlineAllocator<32>> Neighbours;
+	const int32 CellRadius = FMath::CeilToInt(Agent.ConsiderationRadius / AvoidanceCellSize);
+	const FVector Cell = Agent.Location / AvoidanceCellSize;
+	const FIntVector AgentCell(FMath::FloorToInt(Cell.X), FMath::FloorToInt(Cell.Y), FMath::FloorToInt(Cell.Z));
+	for (int32 Z = -CellRadius; Z <= CellRadius; ++Z)
+	{
+		for (int32 Y = -CellRadius; Y <= CellRadius; ++Y)
+		{
+			for (int32 X = -CellRadius; X <= CellRadius; ++X)
+			{
+				const TArray<int32>* CellAgents = AvoidanceHash.Find(AgentCell + FIntVector(X, Y, Z));
+				if (!CellAgents)
+				{
+					continue;
+				}
+
+				for (int32 OtherIndex : *CellAgents)
+				{
+					const FHynmersAvoidanceAgent& Other = AvoidanceAgents[OtherIndex];
+					if (OtherIndex == AgentIndex || (Other.GroupMask & Agent.GroupsToIgnore) != 0 || (Other.GroupMask & Agent.GroupsToAvoid) == 0)
+					{
+						continue;
+					}
+
+					// Characters above or below, on another floor or the other side of a thin wall, are not in the way
+					const FVector Offset = Other.Location - Agent.Location;
+					const float DistSq = Offset.SizeSquared();
+					if (DistSq > FMath::Square(Agent.ConsiderationRadius) || FMath::Abs(Offset | Agent.UpVector) > Agent.HalfHeight + Other.HalfHeight)
+					{
+						continue;
+					}
+
+					Neighbours.Add(TPair<float, int32>(DistSq, OtherIndex));
+				}
+			}
+		}
+	}
+
+	if (Neighbours.Num() == 0)
+	{
+		return;
+	}
+
+	Neighbours.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+	const int32 NumNeighbours = FMath::Min(Neighbours.Num(), MaxAvoidanceNeighbours);
+
+	// Everything projected on the tangent plane of this agent
+	const FVector2D Velocity(Agent.Velocity | Agent.RightVector, Agent.Velocity | Agent.ForwardVector);
+	TArray<FHynmersAvoidanceLine, TInlineAllocator<16>> Lines;
+	for (int32 i = 0; i < NumNeighbours; ++i)
+	{
+		const FHynmersAvoidanceAgent& Other = AvoidanceAgents[Neighbours[i].Value];
+		const FVector Offset = Other.Location - Agent.Location;
+		const FVector2D RelativePosition(Offset | Agent.RightVector, Offset | Agent.ForwardVector);
+		const FVector2D OtherVelocity(Other.Velocity | Agent.RightVector, Other.Velocity | Agent.ForwardVector);
+
+		// The heavier the other agent, the more this one gives way. Agents not solved this frame never take their share.
+		const float TotalWeight = Agent.Weight + Other.Weight;
+		const float Responsibility = !Other.bSolve ? 1.f : (TotalWeight > KINDA_SMALL_NUMBER ? Other.Weight / TotalWeight : 0.5f);
+
+		Lines.Add(HynmersMovementCore::ComputeAvoidanceLine(Velocity, RelativePosition, Velocity - OtherVelocity,
+			Agent.Radius + Other.Radius, AvoidanceTimeHorizon, DeltaSeconds, Responsibility));
+	}
+
+	const FVector2D Result = HynmersMovementCore::SolveAvoidance(Lines.GetData(), Lines.Num(), Velocity, Agent.MaxSpeed);
+	Agent.AvoidanceVelocity = Agent.RightVector * Result.X + Agent.ForwardVector * Result.Y;
+}
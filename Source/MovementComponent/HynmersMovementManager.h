@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "HynmersMovementManager.generated.h"
+
+class UHynmersMovementComponent;
+
+/*
+ * Hot movement state of every registered component, stored as structure of arrays.
+ */
+struct FHynmersMovementBatch
+{
+	TArray<FVector> InputAcceleration;
+	TArray<FVector> UpVector;
+	TArray<FVector> RightVector;
+	TArray<FVector> ForwardVector;
+	TArray<uint8> MovementMode;
+	TArray<float> FloorDist;
+	// Delta time the component simulates this frame, accumulated by reduced tick tiers
+	TArray<float> DeltaTime;
+	// Components that passed the prepare phase and will run the collision phase
+	TArray<uint8> bActive;
+	// Selection of the entries a batched kernel applies to
+	TArray<uint8> Mask;
+
+	void Reset(int32 Num);
+};
+
+// Character taking part in the tangent plane avoidance, gathered every frame
+struct FHynmersAvoidanceAgent
+{
+	FVector Location;
+	FVector Velocity;
+	FVector UpVector;
+	FVector RightVector;
+	FVector ForwardVector;
+	float Radius;
+	float HalfHeight;
+	float MaxSpeed;
+	float ConsiderationRadius;
+	float Weight;
+	int32 GroupMask;
+	int32 GroupsToAvoid;
+	int32 GroupsToIgnore;
+	// Index in the registered components
+	int32 Component;
+	// Active this frame and allowed to avoid, others are only obstacles
+	bool bSolve;
+	FVector AvoidanceVelocity;
+};
+
+/*
+ * Per world manager that owns the tick of the registered UHynmersMovementComponents.
+ * The tick runs the orientation/input phase per component, gathers the hot state into
+ * FHynmersMovementBatch, runs the tick-level math as tight loops and then the collision phase,
+ * where characters standing on another registered character move after it.
+ */
+UCLASS(NotPlaceable, Transient)
+class MOVEMENTCOMPONENT_API AHynmersMovementManager : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AHynmersMovementManager();
+
+	virtual void PostInitializeComponents() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	static AHynmersMovementManager* Find(const UWorld* World);
+
+	static AHynmersMovementManager* FindOrSpawn(UWorld* World);
+
+	// The component stops ticking on its own until it is unregistered
+	void RegisterComponent(UHynmersMovementComponent* Component);
+
+	void UnregisterComponent(UHynmersMovementComponent* Component);
+
+	int32 GetNumComponents() const { return Components.Num(); }
+
+	// Movement tick LOD
+	UPROPERTY(Category = "Significance", EditAnywhere)
+		bool bEnableMovementLOD = true;
+
+	// Seconds between significance updates
+	UPROPERTY(Category = "Significance", EditAnywhere)
+		float SignificanceUpdateInterval = 0.25f;
+
+	// Distance to the closest viewer from which characters simulate every second frame
+	UPROPERTY(Category = "Significance", EditAnywhere)
+		float HalfRateDistance = 2500.f;
+
+	UPROPERTY(Category = "Significance", EditAnywhere)
+		float QuarterRateDistance = 6000.f;
+
+	UPROPERTY(Category = "Significance", EditAnywhere)
+		float ExtrapolateOnlyDistance = 12000.f;
+
+	// Characters whose mesh was not rendered recently drop one more tier
+	UPROPERTY(Category = "Significance", EditAnywhere)
+		float RecentlyRenderedTolerance = 0.5f;
+
+	// Seconds ahead the avoidance looks for collisions with the neighbours
+	UPROPERTY(Category = "Avoidance", EditAnywhere, meta = (ClampMin = "0.01", UIMin = "0.01"))
+		float AvoidanceTimeHorizon = 1.5f;
+
+	// Closest neighbours considered by each character
+	UPROPERTY(Category = "Avoidance", EditAnywhere, meta = (ClampMin = "1", UIMin = "1"))
+		int32 MaxAvoidanceNeighbours = 10;
+
+	// Cells of the neighbour hash, about the avoidance consideration radius of the characters
+	UPROPERTY(Category = "Avoidance", EditAnywhere, meta = (ClampMin = "1", UIMin = "1"))
+		float AvoidanceCellSize = 500.f;
+
+protected:
+	// Batched phases
+	void GatherBatch();
+
+	void ConstrainInputAccelerationBatch();
+
+	void ScatterBatch();
+
+	// Floor queries of every walking character, issued together before the collision phase
+	void PrefetchFloorsParallel();
+
+	// Avoidance velocities of the characters using RVO avoidance, each solved in its own tangent plane
+	void SolveAvoidanceBatch(float DeltaSeconds);
+
+	void SolveAvoidance(int32 AgentIndex, float DeltaSeconds);
+
+	// Assign a tick tier to every component from its distance to the players and its visibility
+	void UpdateSignificance(float DeltaSeconds);
+
+	// Keep ticking after the controllers the components used to depend on
+	void UpdateTickPrerequisites(int32 Index);
+
+	// Collision phase order with bases before the characters standing on them, and tick prerequisites on the other moving bases
+	void UpdateMovementBases();
+
+	struct FRegisteredComponent
+	{
+		TWeakObjectPtr<UHynmersMovementComponent> Component;
+		TWeakObjectPtr<AController> Controller;
+	};
+
+	TArray<FRegisteredComponent> Components;
+
+	FHynmersMovementBatch Batch;
+
+	// Component indices in collision phase order
+	TArray<int32> TickOrder;
+
+	// Moving bases not owned by a registered character, the manager ticks after them
+	TSet<TWeakObjectPtr<UPrimitiveComponent>> BaseTickDependencies;
+
+	TArray<FHynmersAvoidanceAgent> AvoidanceAgents;
+
+	// Agents per cell, rebuilt every frame
+	TMap<FIntVector, TArray<int32>> AvoidanceHash;
+
+	float TimeSinceSignificanceUpdate = 0.f;
+};
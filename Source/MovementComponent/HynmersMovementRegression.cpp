@@ -0,0 +1,204 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementRegression.h"
+#include "HynmersCharacter.h"
+#include "HynmersMovementComponent.h"
+#include "HynmersMovementStats.h"
+#include "HynmersMovementTestWorld.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace HynmersMovementRegression
+{
+	static const TCHAR* GoldenHeader = TEXT("HynmersGolden1");
+
+	void GetScenarios(TArray<FScenario>& OutScenarios)
+	{
+		OutScenarios.Add({ TEXT("StairsStepUp"), 240, [](FHynmersMovementTestWorld& World)
+		{
+			TArray<FHynmersTestSpawn> Spawns;
+			World.BuildStairs(FVector::ZeroVector, 12, 30.f, 40.f, 600.f, Spawns);
+			return FHynmersTestSpawn(FVector(-300.f, 0.f, 0.f));
+		}, false });
+
+		OutScenarios.Add({ TEXT("WalkOffLedge"), 180, [](FHynmersMovementTestWorld& World)
+		{
+			World.AddBox(FVector(0.f, 0.f, -50.f), FVector(3000.f, 3000.f, 50.f));
+			World.AddBox(FVector(0.f, 0.f, 150.f), FVector(500.f, 500.f, 50.f));
+			return FHynmersTestSpawn(FVector(0.f, 0.f, 200.f));
+		}, false });
+
+		OutScenarios.Add({ TEXT("SlopeLanding"), 180, [](FHynmersMovementTestWorld& World)
+		{
+			World.AddBox(FVector(0.f, 0.f, -50.f), FVector(3000.f, 3000.f, 50.f));
+			World.AddBox(FVector(0.f, 0.f, 250.f), FVector(800.f, 400.f, 10.f), FRotator(30.f, 0.f, 0.f));
+			return FHynmersTestSpawn(FVector(0.f, 0.f, 600.f));
+		}, false });
+
+		OutScenarios.Add({ TEXT("TwoWallAdjust"), 240, [](FHynmersMovementTestWorld& World)
+		{
+			// Wedge opening toward -X with its apex at the origin
+			World.AddBox(FVector(0.f, 0.f, -50.f), FVector(3000.f, 3000.f, 50.f));
+			const float HalfAngle = 30.f;
+			for (const float Sign : { 1.f, -1.f })
+			{
+				const FRotator Yaw(0.f, Sign * HalfAngle, 0.f);
+				World.AddBox(-Yaw.Vector() * 600.f + FVector(0.f, 0.f, 200.f), FVector(600.f, 10.f, 200.f), Yaw);
+			}
+			// Slightly off the bisector so one wall is hit first
+			return FHynmersTestSpawn(FVector(-700.f, 20.f, 0.f));
+		}, false });
+
+		OutScenarios.Add({ TEXT("CubeEdgeWrap"), 300, [](FHynmersMovementTestWorld& World)
+		{
+			TArray<FHynmersTestSpawn> Spawns;
+			World.BuildCubePlanet(FVector::ZeroVector, 1000.f, Spawns);
+			return FHynmersTestSpawn(FVector(700.f, 0.f, 1000.f));
+		}, false });
+
+		OutScenarios.Add({ TEXT("SwimToSurface"), 300, [](FHynmersMovementTestWorld& World)
+		{
+			World.AddBox(FVector(0.f, 0.f, -50.f), FVector(3000.f, 3000.f, 50.f));
+			World.AddWaterBox(FVector(0.f, 0.f, 500.f), FVector(1500.f, 1500.f, 500.f));
+			return FHynmersTestSpawn(FVector::ZeroVector);
+		}, true });
+
+		OutScenarios.Add({ TEXT("SwimToSurfaceAnalytic"), 300, [](FHynmersMovementTestWorld& World)
+		{
+			World.AddBox(FVector(0.f, 0.f, -50.f), FVector(3000.f, 3000.f, 50.f));
+			World.AddWaterBody(FVector(0.f, 0.f, 500.f), FVector(1500.f, 1500.f, 500.f));
+			return FHynmersTestSpawn(FVector::ZeroVector);
+		}, true });
+
+		OutScenarios.Add({ TEXT("RotatingPlatformIdle"), 240, [](FHynmersMovementTestWorld& World)
+		{
+			// The character rides off the pivot, carried around and turned by the base
+			World.AddRotatingBox(FVector(0.f, 0.f, -50.f), FVector(800.f, 800.f, 50.f), FRotator(0.f, 45.f, 0.f));
+			return FHynmersTestSpawn(FVector(400.f, 0.f, 0.f));
+		}, false, true });
+	}
+
+	bool RunScenario(const FScenario& Scenario, bool bUseMovementManager, FTrajectory& OutTrajectory)
+	{
+		FHynmersMovementTestWorld TestWorld;
+		if (!TestWorld.Initialize())
+		{
+			return false;
+		}
+
+		AHynmersCharacter* Character = TestWorld.SpawnCharacter(Scenario.Build(TestWorld), bUseMovementManager);
+		if (!Character)
+		{
+			return false;
+		}
+		UCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement();
+
+		FHynmersMovementCounters& Counters = FHynmersMovementCounters::Get();
+		Counters.Reset();
+
+		OutTrajectory.Samples.Reset(Scenario.NumFrames);
+		OutTrajectory.Milliseconds = 0.0;
+		for (int32 Frame = 0; Frame < Scenario.NumFrames; ++Frame)
+		{
+			if (!Scenario.bStandStill)
+			{
+				Character->AddMovementInput(Character->GetActorForwardVector(), 1.f);
+			}
+			if (Scenario.bSwimUp)
+			{
+				Character->AddMovementInput(Character->GetActorUpVector(), 1.f);
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			TestWorld.Tick(FrameTime);
+			OutTrajectory.Milliseconds += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+			FTrajectorySample& Sample = OutTrajectory.Samples[OutTrajectory.Samples.AddUninitialized()];
+			Sample.MovementMode = MovementComponent->MovementMode;
+			Sample.Location = Character->GetActorLocation();
+			Sample.Velocity = MovementComponent->Velocity;
+			Sample.UpVector = Character->GetActorUpVector();
+		}
+
+		OutTrajectory.Queries = Counters.GetTotal(EHynmersMovementCounter::Sweeps) + Counters.GetTotal(EHynmersMovementCounter::LineTraces);
+		OutTrajectory.RebasedFloors = Counters.GetTotal(EHynmersMovementCounter::RebasedFloors);
+		return true;
+	}
+
+	bool SaveGolden(const FString& Filename, const FScenario& Scenario, const FTrajectory& Trajectory)
+	{
+		FString Text = FString::Printf(TEXT("%s,%s,%d,%.4f,%d\n"), GoldenHeader, Scenario.Name, Trajectory.Samples.Num(), Trajectory.Milliseconds, Trajectory.Queries);
+		for (const FTrajectorySample& Sample : Trajectory.Samples)
+		{
+			Text += FString::Printf(TEXT("%u,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.6f,%.6f,%.6f\n"), Sample.MovementMode,
+				Sample.Location.X, Sample.Location.Y, Sample.Location.Z, Sample.Velocity.X, Sample.Velocity.Y, Sample.Velocity.Z,
+				Sample.UpVector.X, Sample.UpVector.Y, Sample.UpVector.Z);
+		}
+		return FFileHelper::SaveStringToFile(Text, *Filename);
+	}
+
+	bool LoadGolden(const FString& Filename, FTrajectory& OutTrajectory)
+	{
+		FString Text;
+		if (!FFileHelper::LoadFileToString(Text, *Filename))
+		{
+			return false;
+		}
+
+		TArray<FString> Lines;
+		Text.ParseIntoArrayLines(Lines);
+
+		TArray<FString> Values;
+		if (Lines.Num() == 0 || Lines[0].ParseIntoArray(Values, TEXT(",")) != 5 || Values[0] != GoldenHeader)
+		{
+			return false;
+		}
+		OutTrajectory.Milliseconds = FCString::Atod(*Values[3]);
+		OutTrajectory.Queries = FCString::Atoi(*Values[4]);
+
+		OutTrajectory.Samples.Reset(Lines.Num() - 1);
+		for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+		{
+			if (Lines[LineIndex].ParseIntoArray(Values, TEXT(",")) != 10)
+			{
+				return false;
+			}
+
+			FTrajectorySample& Sample = OutTrajectory.Samples[OutTrajectory.Samples.AddUninitialized()];
+			Sample.MovementMode = (uint8)FCString::Atoi(*Values[0]);
+			Sample.Location = FVector(FCString::Atof(*Values[1]), FCString::Atof(*Values[2]), FCString::Atof(*Values[3]));
+			Sample.Velocity = FVector(FCString::Atof(*Values[4]), FCString::Atof(*Values[5]), FCString::Atof(*Values[6]));
+			Sample.UpVector = FVector(FCString::Atof(*Values[7]), FCString::Atof(*Values[8]), FCString::Atof(*Values[9]));
+		}
+		return true;
+	}
+
+	FString GetDefaultGoldenDir()
+	{
+		return FPaths::ProjectDir() / TEXT("Tests") / TEXT("MovementGolden");
+	}
+
+	FTrajectoryComparison CompareTrajectories(const FTrajectory& Expected, const FTrajectory& Actual)
+	{
+		FTrajectoryComparison Result;
+		float MinUpDot = 1.f;
+		Result.ModeMismatches = FMath::Abs(Expected.Samples.Num() - Actual.Samples.Num());
+		const int32 NumSamples = FMath::Min(Expected.Samples.Num(), Actual.Samples.Num());
+		for (int32 i = 0; i < NumSamples; ++i)
+		{
+			const FTrajectorySample& ExpectedSample = Expected.Samples[i];
+			const FTrajectorySample& ActualSample = Actual.Samples[i];
+			Result.MaxLocationError = FMath::Max(Result.MaxLocationError, FVector::Dist(ExpectedSample.Location, ActualSample.Location));
+			MinUpDot = FMath::Min(MinUpDot, ExpectedSample.UpVector | ActualSample.UpVector);
+			Result.ModeMismatches += ExpectedSample.MovementMode != ActualSample.MovementMode ? 1 : 0;
+		}
+		Result.MaxUpErrorDegrees = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(MinUpDot, -1.f, 1.f)));
+		return Result;
+	}
+
+	bool FTrajectoryComparison::IsWithin(float Tolerance, float UpToleranceDegrees) const
+	{
+		return MaxLocationError <= Tolerance && MaxUpErrorDegrees <= UpToleranceDegrees && ModeMismatches == 0;
+	}
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HynmersMovementTestWorld.h"
+
+/*
+ * Canonical movement scenarios and their golden trajectories, shared by the regression commandlet and the automation tests.
+ */
+namespace HynmersMovementRegression
+{
+	static const float FrameTime = 1.f / 60.f;
+
+	struct FTrajectorySample
+	{
+		uint8 MovementMode;
+		FVector Location;
+		FVector Velocity;
+		FVector UpVector;
+	};
+
+	struct FTrajectory
+	{
+		TArray<FTrajectorySample> Samples;
+		double Milliseconds = 0.0;
+		int32 Queries = 0;
+		// Floor checks answered by moving the floor with the base, not saved in goldens
+		int32 RebasedFloors = 0;
+	};
+
+	struct FScenario
+	{
+		const TCHAR* Name;
+		int32 NumFrames;
+		// Builds the geometry and returns where the character starts
+		TFunction<FHynmersTestSpawn(FHynmersMovementTestWorld&)> Build;
+		bool bSwimUp;
+		// No input, the character only moves with its base
+		bool bStandStill = false;
+	};
+
+	struct FTrajectoryComparison
+	{
+		float MaxLocationError = 0.f;
+		float MaxUpErrorDegrees = 0.f;
+		int32 ModeMismatches = 0;
+
+		// Location tolerance in cm, up vector tolerance in degrees
+		bool IsWithin(float Tolerance, float UpToleranceDegrees) const;
+	};
+
+	MOVEMENTCOMPONENT_API void GetScenarios(TArray<FScenario>& OutScenarios);
+
+	MOVEMENTCOMPONENT_API bool RunScenario(const FScenario& Scenario, bool bUseMovementManager, FTrajectory& OutTrajectory);
+
+	MOVEMENTCOMPONENT_API bool SaveGolden(const FString& Filename, const FScenario& Scenario, const FTrajectory& Trajectory);
+
+	MOVEMENTCOMPONENT_API bool LoadGolden(const FString& Filename, FTrajectory& OutTrajectory);
+
+	// Tests/MovementGolden in the project directory
+	MOVEMENTCOMPONENT_API FString GetDefaultGoldenDir();
+
+	MOVEMENTCOMPONENT_API FTrajectoryComparison CompareTrajectories(const FTrajectory& Expected, const FTrajectory& Actual);
+}
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementRegressionCommandlet.h"
+#include "HynmersMovementRegression.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHynmersMovementRegression, Log, All);
+
+UHynmersMovementRegressionCommandlet::UHynmersMovementRegressionCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UHynmersMovementRegressionCommandlet::Main(const FString& Params)
+{
+	using namespace HynmersMovementRegression;
+
+	const bool bRecord = FParse::Param(*Params, TEXT("Record"));
+	const bool bUseMovementManager = !FParse::Param(*Params, TEXT("NoManager"));
+
+	FString GoldenDir = GetDefaultGoldenDir();
+	FParse::Value(*Params, TEXT("Golden="), GoldenDir);
+
+	FString ScenarioFilter;
+	FParse::Value(*Params, TEXT("Scenario="), ScenarioFilter);
+
+	// Location tolerance in cm, up vector tolerance in degrees
+	float Tolerance = 1.f;
+	float UpTolerance = 1.f;
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+	FParse::Value(*Params, TEXT("UpTolerance="), UpTolerance);
+
+	FString ReportFilename = FPaths::ProjectSavedDir() / TEXT("MovementRegression") / FString::Printf(TEXT("Regression-%s.csv"), *FDateTime::Now().ToString());
+	FParse::Value(*Params, TEXT("Report="), ReportFilename);
+
+	TArray<FScenario> Scenarios;
+	GetScenarios(Scenarios);
+
+	int32 NumFailed = 0;
+	FString Report = TEXT("Scenario,Result,Frames,MaxLocationError,MaxUpErrorDegrees,ModeMismatches,Milliseconds,GoldenMilliseconds,Speedup,Queries,GoldenQueries\n");
+	for (const FScenario& Scenario : Scenarios)
+	{
+		if (!ScenarioFilter.IsEmpty() && ScenarioFilter != Scenario.Name)
+		{
+			continue;
+		}
+
+		const FString GoldenFilename = GoldenDir / FString(Scenario.Name) + TEXT(".csv");
+
+		FTrajectory Trajectory;
+		if (!RunScenario(Scenario, bUseMovementManager, Trajectory))
+		{
+			UE_LOG(LogHynmersMovementRegression, Error, TEXT("%s: could not set up the scenario"), Scenario.Name);
+			Report += FString::Printf(TEXT("%s,Error,0,0,0,0,0,0,0,0,0\n"), Scenario.Name);
+			++NumFailed;
+			continue;
+		}
+
+		if (bRecord)
+		{
+			if (!SaveGolden(GoldenFilename, Scenario, Trajectory))
+			{
+				UE_LOG(LogHynmersMovementRegression, Error, TEXT("%s: could not write %s"), Scenario.Name, *GoldenFilename);
+				++NumFailed;
+				continue;
+			}
+			UE_LOG(LogHynmersMovementRegression, Display, TEXT("%s: recorded %d frames, %.3f ms, %d queries"), Scenario.Name, Trajectory.Samples.Num(), Trajectory.Milliseconds, Trajectory.Queries);
+			Report += FString::Printf(TEXT("%s,Recorded,%d,0,0,0,%.4f,%.4f,1,%d,%d\n"), Scenario.Name, Trajectory.Samples.Num(), Trajectory.Milliseconds, Trajectory.Milliseconds, Trajectory.Queries, Trajectory.Queries);
+			continue;
+		}
+
+		FTrajectory Golden;
+		if (!LoadGolden(GoldenFilename, Golden))
+		{
+			UE_LOG(LogHynmersMovementRegression, Error, TEXT("%s: missing or invalid golden file %s, run with -Record first"), Scenario.Name, *GoldenFilename);
+			Report += FString::Printf(TEXT("%s,NoGolden,%d,0,0,0,%.4f,0,0,%d,0\n"), Scenario.Name, Trajectory.Samples.Num(), Trajectory.Milliseconds, Trajectory.Queries);
+			++NumFailed;
+			continue;
+		}
+
+		const FTrajectoryComparison Comparison = CompareTrajectories(Golden, Trajectory);
+		const bool bPassed = Comparison.IsWithin(Tolerance, UpTolerance);
+		const float MaxLocationError = Comparison.MaxLocationError;
+		const float MaxUpError = Comparison.MaxUpErrorDegrees;
+		const int32 ModeMismatches = Comparison.ModeMismatches;
+		const double Speedup = Trajectory.Milliseconds > 0.0 ? Golden.Milliseconds / Trajectory.Milliseconds : 0.0;
+		NumFailed += bPassed ? 0 : 1;
+
+		UE_LOG(LogHynmersMovementRegression, Display, TEXT("%s: %s, location error %.3f, up error %.3f deg, %d mode mismatches, %.3f ms (golden %.3f ms, x%.2f), %d queries (golden %d)"),
+			Scenario.Name, bPassed ? TEXT("passed") : TEXT("FAILED"), MaxLocationError, MaxUpError, ModeMismatches,
+			Trajectory.Milliseconds, Golden.Milliseconds, Speedup, Trajectory.Queries, Golden.Queries);
+		Report += FString::Printf(TEXT("%s,%s,%d,%.4f,%.4f,%d,%.4f,%.4f,%.3f,%d,%d\n"), Scenario.Name, bPassed ? TEXT("Passed") : TEXT("Failed"),
+			Trajectory.Samples.Num(), MaxLocationError, MaxUpError, ModeMismatches, Trajectory.Milliseconds, Golden.Milliseconds, Speedup,
+			Trajectory.Queries, Golden.Queries);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Report, *ReportFilename))
+	{
+		UE_LOG(LogHynmersMovementRegression, Warning, TEXT("Could not write the report to %s"), *ReportFilename);
+	}
+
+	return NumFailed > 0 ? 1 : 0;
+}
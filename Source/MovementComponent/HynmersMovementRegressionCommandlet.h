@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HynmersMovementRegressionCommandlet.generated.h"
+
+/*
+ * Golden trajectory regression of canonical movement scenarios, with the query count and time of each run.
+ * -run=HynmersMovementRegression -nullrhi [-Record] [-Golden=<dir>] [-Scenario=<name>] [-Tolerance=1.0] [-NoManager] [-Report=<file.csv>]
+ * Without -Record the runs are verified against the golden files and compared to their recorded cost.
+ */
+UCLASS()
+class UHynmersMovementRegressionCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UHynmersMovementRegressionCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
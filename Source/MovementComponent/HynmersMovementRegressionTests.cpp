@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementRegression.h"
+
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HynmersMovementRegression
+{
+	static const float TestTolerance = 1.f;
+	static const float TestUpTolerance = 1.f;
+
+	// Runs one scenario through the movement manager. The trajectory has to match the checked in golden file
+	// and the same scenario ticked per component without the manager.
+	static bool RunScenarioTest(FAutomationTestBase& Test, const TCHAR* ScenarioName)
+	{
+		TArray<FScenario> Scenarios;
+		GetScenarios(Scenarios);
+		const FScenario* Scenario = Scenarios.FindByPredicate([ScenarioName](const FScenario& Candidate) { return FCString::Strcmp(Candidate.Name, ScenarioName) == 0; });
+		if (!Scenario)
+		{
+			Test.AddError(FString::Printf(TEXT("Unknown scenario %s"), ScenarioName));
+			return false;
+		}
+
+		FTrajectory Managed;
+		FTrajectory Unmanaged;
+		if (!RunScenario(*Scenario, true, Managed) || !RunScenario(*Scenario, false, Unmanaged))
+		{
+			Test.AddError(FString::Printf(TEXT("%s: could not set up the scenario"), ScenarioName));
+			return false;
+		}
+
+		const FTrajectoryComparison PathComparison = CompareTrajectories(Unmanaged, Managed);
+		Test.TestTrue(FString::Printf(TEXT("%s: manager matches the component tick (location error %.3f, up error %.3f deg, %d mode mismatches)"),
+			ScenarioName, PathComparison.MaxLocationError, PathComparison.MaxUpErrorDegrees, PathComparison.ModeMismatches),
+			PathComparison.IsWithin(TestTolerance, TestUpTolerance));
+
+		if (Scenario->bStandStill)
+		{
+			// Once landed, every floor check of a character carried by its base reuses the moved floor instead of sweeping
+			const int32 MinRebasedFloors = Scenario->NumFrames / 2;
+			Test.TestTrue(FString::Printf(TEXT("%s: floor moved with the base without a sweep (%d managed, %d unmanaged, %d expected)"),
+				ScenarioName, Managed.RebasedFloors, Unmanaged.RebasedFloors, MinRebasedFloors),
+				Managed.RebasedFloors >= MinRebasedFloors && Unmanaged.RebasedFloors >= MinRebasedFloors);
+		}
+
+		const FString GoldenFilename = GetDefaultGoldenDir() / FString(ScenarioName) + TEXT(".csv");
+		FTrajectory Golden;
+		if (!FPaths::FileExists(GoldenFilename))
+		{
+			Test.AddError(FString::Printf(TEXT("%s: no golden file %s, record it with -run=HynmersMovementRegression -Record"), ScenarioName, *GoldenFilename));
+			return false;
+		}
+		if (!LoadGolden(GoldenFilename, Golden))
+		{
+			Test.AddError(FString::Printf(TEXT("%s: invalid golden file %s"), ScenarioName, *GoldenFilename));
+			return false;
+		}
+
+		const FTrajectoryComparison GoldenComparison = CompareTrajectories(Golden, Managed);
+		Test.TestTrue(FString::Printf(TEXT("%s: matches the golden trajectory (location error %.3f, up error %.3f deg, %d mode mismatches)"),
+			ScenarioName, GoldenComparison.MaxLocationError, GoldenComparison.MaxUpErrorDegrees, GoldenComparison.ModeMismatches),
+			GoldenComparison.IsWithin(TestTolerance, TestUpTolerance));
+		Test.AddInfo(FString::Printf(TEXT("%s: %.3f ms (golden %.3f ms), %d queries (golden %d)"), ScenarioName, Managed.Milliseconds, Golden.Milliseconds, Managed.Queries, Golden.Queries));
+		return true;
+	}
+}
+
+#define HYNMERS_MOVEMENT_REGRESSION_TEST(ScenarioName) \
+	IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHynmersMovementRegression##ScenarioName##Test, "Hynmers.Movement.Regression." #ScenarioName, \
+		EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter) \
+	bool FHynmersMovementRegression##ScenarioName##Test::RunTest(const FString& Parameters) \
+	{ \
+		return HynmersMovementRegression::RunScenarioTest(*this, TEXT(#ScenarioName)); \
+	}
+
+HYNMERS_MOVEMENT_REGRESSION_TEST(StairsStepUp)
+HYNMERS_MOVEMENT_REGRESSION_TEST(WalkOffLedge)
+HYNMERS_MOVEMENT_REGRESSION_TEST(SlopeLanding)
+HYNMERS_MOVEMENT_REGRESSION_TEST(TwoWallAdjust)
+HYNMERS_MOVEMENT_REGRESSION_TEST(CubeEdgeWrap)
+HYNMERS_MOVEMENT_REGRESSION_TEST(SwimToSurface)
+HYNMERS_MOVEMENT_REGRESSION_TEST(SwimToSurfaceAnalytic)
+HYNMERS_MOVEMENT_REGRESSION_TEST(RotatingPlatformIdle)
+
+#undef HYNMERS_MOVEMENT_REGRESSION_TEST
+
+#endif // WITH_DEV_AUTOMATION_TESTS
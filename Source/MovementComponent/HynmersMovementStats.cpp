@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementStats.h"
+
+DEFINE_STAT(STAT_HynmersSweeps);
+DEFINE_STAT(STAT_HynmersLineTraces);
+DEFINE_STAT(STAT_HynmersMoveComponent);
+DEFINE_STAT(STAT_HynmersIterations);
+DEFINE_STAT(STAT_HynmersIterationsWalking);
+DEFINE_STAT(STAT_HynmersIterationsFalling);
+DEFINE_STAT(STAT_HynmersIterationsSwimming);
+DEFINE_STAT(STAT_HynmersIterationCaps);
+DEFINE_STAT(STAT_HynmersOverlaps);
+DEFINE_STAT(STAT_HynmersFieldFloors);
+DEFINE_STAT(STAT_HynmersRebasedFloors);
+
+FHynmersMovementCounters& FHynmersMovementCounters::Get()
+{
+	static FHynmersMovementCounters Counters = []()
+	{
+		FHynmersMovementCounters NewCounters;
+		NewCounters.Reset();
+		return NewCounters;
+	}();
+	return Counters;
+}
+
+void FHynmersMovementCounters::Reset()
+{
+	FMemory::Memzero(Values);
+}
+
+int32 FHynmersMovementCounters::GetTotal(EHynmersMovementCounter Counter) const
+{
+	int32 Total = 0;
+	for (int32 Mode = 0; Mode < MOVE_MAX; ++Mode)
+	{
+		Total += Values[(int32)Counter][Mode];
+	}
+	return Total;
+}
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Engine/EngineTypes.h"
+
+DECLARE_STATS_GROUP(TEXT("HynmersMovement"), STATGROUP_HynmersMovement, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Sweeps"), STAT_HynmersSweeps, STATGROUP_HynmersMovement, MOVEMENTCOMPONENT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Line traces"), STAT_HynmersLineTraces, STATGROUP_HynmersMovement, MOVEMENTCOMPONENT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("MoveComponent calls"), STAT_HynmersMoveComponent, STATGROUP_HynmersMovement, MOVEMENTCOMPONENT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Iterations"), STAT_HynmersIterations, STATGROUP_HynmersMovement, MOVEMENTCOMPONENT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Iterations Walking"), STAT_HynmersIterationsWalking, STATGROUP_HynmersMovement, MOVEMENTCOMPONENT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Iterations Falling"), STAT_HynmersIterationsFalling, STATGROUP_HynmersMovement, MOVEMENTCOMPONENT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Iterations Swimming"), STAT_HynmersIterationsSwimming, STATGROUP_HynmersMovement, MOVEMENTCOMPONENT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Iteration caps hit"), STAT_HynmersIterationCaps, STATGROUP_HynmersMovement, MOVEMENTCOMPONENT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Overlaps"), STAT_HynmersOverlaps, STATGROUP_HynmersMovement, MOVEMENTCOMPONENT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Distance field floors"), STAT_HynmersFieldFloors, STATGROUP_HynmersMovement, MOVEMENTCOMPONENT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Floors moved with the base"), STAT_HynmersRebasedFloors, STATGROUP_HynmersMovement, MOVEMENTCOMPONENT_API);
+
+enum class EHynmersMovementCounter : uint8
+{
+	Sweeps,
+	LineTraces,
+	MoveComponent,
+	Iterations,
+	IterationCaps,
+	Overlaps,
+	FieldFloors,
+	RebasedFloors,
+	Num
+};
+
+/*
+ * Counters of the movement pipeline per movement mode, kept outside of the stats system
+ * so they are also available in builds without stats. Cumulated until Reset.
+ */
+struct MOVEMENTCOMPONENT_API FHynmersMovementCounters
+{
+	int32 Values[(int32)EHynmersMovementCounter::Num][MOVE_MAX];
+
+	static FHynmersMovementCounters& Get();
+
+	void Reset();
+
+	int32 GetTotal(EHynmersMovementCounter Counter) const;
+
+	FORCEINLINE void Increment(EHynmersMovementCounter Counter, uint8 MovementMode)
+	{
+		FPlatformAtomics::InterlockedIncrement(&Values[(int32)Counter][MovementMode < MOVE_MAX ? MovementMode : MOVE_None]);
+	}
+};
+
+#define HYNMERS_COUNT(Counter, StatName, MovementMode) \
+	do \
+	{ \
+		INC_DWORD_STAT(StatName); \
+		FHynmersMovementCounters::Get().Increment(EHynmersMovementCounter::Counter, MovementMode); \
+	} while (0)
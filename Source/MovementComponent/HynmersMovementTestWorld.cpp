@@ -0,0 +1,271 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementTestWorld.h"
+#include "HynmersCharacter.h"
+#include "HynmersGravitySourceComponent.h"
+#include "HynmersMovementComponent.h"
+#include "HynmersStaticDistanceField.h"
+#include "HynmersWaterBody.h"
+
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/PhysicsVolume.h"
+#include "GameFramework/RotatingMovementComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "Components/BrushComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+
+const float FHynmersMovementTestWorld::CapsuleRadius = 55.f;
+const float FHynmersMovementTestWorld::CapsuleHalfHeight = 96.f;
+
+namespace HynmersTestWorld
+{
+	// Engine basic shapes are 100 units wide
+	static const float ShapeHalfSize = 50.f;
+
+	// No brush builders at runtime, the brush collision is a simple box traced as complex
+	static void SetBoxBrush(APhysicsVolume* Volume, const FVector& Extent)
+	{
+		UBrushComponent* BrushComponent = Volume->GetBrushComponent();
+		UBodySetup* BodySetup = NewObject<UBodySetup>(BrushComponent);
+		BodySetup->AggGeom.BoxElems.Add(FKBoxElem(Extent.X * 2.f, Extent.Y * 2.f, Extent.Z * 2.f));
+		BodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+		BodySetup->CreatePhysicsMeshes();
+		BrushComponent->BrushBodySetup = BodySetup;
+	}
+}
+
+FHynmersMovementTestWorld::FHynmersMovementTestWorld()
+	: World(nullptr)
+	, CubeMesh(nullptr)
+	, SphereMesh(nullptr)
+{
+}
+
+FHynmersMovementTestWorld::~FHynmersMovementTestWorld()
+{
+	Shutdown();
+}
+
+bool FHynmersMovementTestWorld::Initialize()
+{
+	CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	SphereMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+	if (!GEngine || !CubeMesh || !SphereMesh)
+	{
+		return false;
+	}
+
+	World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->AddToRoot();
+
+	World->InitializeActorsForPlay(FURL());
+
+	// No game mode, begin play directly
+	World->GetWorldSettings()->NotifyBeginPlay();
+
+	return true;
+}
+
+void FHynmersMovementTestWorld::Shutdown()
+{
+	if (World)
+	{
+		World->RemoveFromRoot();
+		World->DestroyWorld(false);
+		GEngine->DestroyWorldContext(World);
+		World = nullptr;
+	}
+}
+
+AStaticMeshActor* FHynmersMovementTestWorld::AddBox(const FVector& Center, const FVector& Extent, const FRotator& Rotation)
+{
+	const FTransform Transform(Rotation, Center, Extent / HynmersTestWorld::ShapeHalfSize);
+	AStaticMeshActor* Actor = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
+	Actor->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+	Actor->FinishSpawning(Transform);
+	return Actor;
+}
+
+AStaticMeshActor* FHynmersMovementTestWorld::AddRotatingBox(const FVector& Center, const FVector& Extent, const FRotator& RotationRate)
+{
+	const FTransform Transform(FRotator::ZeroRotator, Center, Extent / HynmersTestWorld::ShapeHalfSize);
+	AStaticMeshActor* Actor = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
+	Actor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+	Actor->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+	Actor->FinishSpawning(Transform);
+
+	URotatingMovementComponent* Rotation = NewObject<URotatingMovementComponent>(Actor);
+	Rotation->RotationRate = RotationRate;
+	// The actor has begun play, registering also starts ticking the rotation
+	Rotation->RegisterComponent();
+	return Actor;
+}
+
+AStaticMeshActor* FHynmersMovementTestWorld::AddSphere(const FVector& Center, float Radius)
+{
+	const FTransform Transform(FRotator::ZeroRotator, Center, FVector(Radius / HynmersTestWorld::ShapeHalfSize));
+	AStaticMeshActor* Actor = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
+	Actor->GetStaticMeshComponent()->SetStaticMesh(SphereMesh);
+	Actor->FinishSpawning(Transform);
+	return Actor;
+}
+
+APhysicsVolume* FHynmersMovementTestWorld::AddWaterBox(const FVector& Center, const FVector& Extent)
+{
+	const FTransform Transform(Center);
+	APhysicsVolume* Volume = World->SpawnActorDeferred<APhysicsVolume>(APhysicsVolume::StaticClass(), Transform);
+	Volume->bWaterVolume = true;
+	HynmersTestWorld::SetBoxBrush(Volume, Extent);
+	Volume->FinishSpawning(Transform);
+	return Volume;
+}
+
+AHynmersWaterBody* FHynmersMovementTestWorld::AddWaterBody(const FVector& Center, const FVector& Extent)
+{
+	const FTransform Transform(Center);
+	AHynmersWaterBody* WaterBody = World->SpawnActorDeferred<AHynmersWaterBody>(AHynmersWaterBody::StaticClass(), Transform);
+	WaterBody->Shape = EHynmersWaterShape::Box;
+	WaterBody->BoxExtent = Extent;
+	HynmersTestWorld::SetBoxBrush(WaterBody, Extent);
+	WaterBody->FinishSpawning(Transform);
+	return WaterBody;
+}
+
+void FHynmersMovementTestWorld::AddPointGravity(const FVector& Center, float InfluenceRadius, float Strength)
+{
+	AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Center));
+
+	UHynmersGravitySourceComponent* Source = NewObject<UHynmersGravitySourceComponent>(Actor);
+	Source->Shape = EHynmersGravityShape::Point;
+	Source->InfluenceRadius = InfluenceRadius;
+	Source->Strength = Strength;
+	Actor->SetRootComponent(Source);
+	Source->SetWorldLocation(Center);
+	// The actor has begun play, registering also begins play and adds the source to the gravity manager
+	Source->RegisterComponent();
+}
+
+AHynmersStaticDistanceField* FHynmersMovementTestWorld::AddStaticDistanceField()
+{
+	return World->SpawnActor<AHynmersStaticDistanceField>(AHynmersStaticDistanceField::StaticClass(), FTransform::Identity);
+}
+
+void FHynmersMovementTestWorld::BuildFloor(const FVector& Origin, float HalfSize, TArray<FHynmersTestSpawn>& OutSpawns)
+{
+	AddBox(Origin - FVector(0.f, 0.f, 50.f), FVector(HalfSize, HalfSize, 50.f));
+
+	// Grid of spawns keeping a capsule of margin to the borders
+	const float Spacing = CapsuleRadius * 4.f;
+	for (float X = -HalfSize + Spacing; X < HalfSize - Spacing; X += Spacing)
+	{
+		for (float Y = -HalfSize + Spacing; Y < HalfSize - Spacing; Y += Spacing)
+		{
+			OutSpawns.Add(FHynmersTestSpawn(Origin + FVector(X, Y, 0.f)));
+		}
+	}
+}
+
+void FHynmersMovementTestWorld::BuildStairs(const FVector& Origin, int32 NumSteps, float StepHeight, float StepDepth, float Width, TArray<FHynmersTestSpawn>& OutSpawns)
+{
+	AddBox(Origin + FVector(-500.f, 0.f, -50.f), FVector(500.f, Width * 0.5f, 50.f));
+
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		const float Height = StepHeight * (Step + 1);
+		AddBox(Origin + FVector(StepDepth * (Step + 0.5f), 0.f, Height * 0.5f), FVector(StepDepth * 0.5f, Width * 0.5f, Height * 0.5f));
+	}
+
+	// Landing at the top
+	const float TopHeight = StepHeight * NumSteps;
+	AddBox(Origin + FVector(StepDepth * NumSteps + 500.f, 0.f, TopHeight * 0.5f), FVector(500.f, Width * 0.5f, TopHeight * 0.5f));
+
+	for (float Y = -Width * 0.5f + CapsuleRadius * 2.f; Y < Width * 0.5f - CapsuleRadius * 2.f; Y += CapsuleRadius * 3.f)
+	{
+		OutSpawns.Add(FHynmersTestSpawn(Origin + FVector(-300.f, Y, 0.f)));
+	}
+}
+
+void FHynmersMovementTestWorld::BuildRamps(const FVector& Origin, float Length, float Width, TArray<FHynmersTestSpawn>& OutSpawns)
+{
+	// Walkable, steep walkable and unwalkable slopes side by side
+	const float Angles[] = { 15.f, 35.f, 55.f };
+
+	AddBox(Origin + FVector(0.f, 0.f, -50.f), FVector(Length * 2.f, Width * 2.f, 50.f));
+
+	for (int32 i = 0; i < ARRAY_COUNT(Angles); ++i)
+	{
+		const float Y = (i - 1) * Width * 1.2f;
+		const FRotator Pitch(Angles[i], 0.f, 0.f);
+		const FVector RampCenter = Origin + FVector(Length * 0.5f, Y, FMath::Sin(FMath::DegreesToRadians(Angles[i])) * Length * 0.5f);
+		AddBox(RampCenter, FVector(Length * 0.5f, Width * 0.5f, 10.f), Pitch);
+
+		OutSpawns.Add(FHynmersTestSpawn(Origin + FVector(-Length * 0.5f, Y, 0.f)));
+	}
+}
+
+void FHynmersMovementTestWorld::BuildCubePlanet(const FVector& Center, float HalfSize, TArray<FHynmersTestSpawn>& OutSpawns)
+{
+	AddBox(Center, FVector(HalfSize));
+	AddPointGravity(Center, HalfSize * 4.f);
+
+	// Spawns on every face, walking toward the edges
+	const FVector Normals[] = { FVector::UpVector, -FVector::UpVector, FVector::ForwardVector, -FVector::ForwardVector, FVector::RightVector, -FVector::RightVector };
+	for (const FVector& Normal : Normals)
+	{
+		OutSpawns.Add(FHynmersTestSpawn(Center + Normal * HalfSize, Normal));
+	}
+}
+
+void FHynmersMovementTestWorld::BuildSpherePlanet(const FVector& Center, float Radius, TArray<FHynmersTestSpawn>& OutSpawns)
+{
+	AddSphere(Center, Radius);
+	AddPointGravity(Center, Radius * 4.f);
+
+	// Fibonacci sphere
+	const int32 NumSpawns = 32;
+	const float GoldenAngle = PI * (3.f - FMath::Sqrt(5.f));
+	for (int32 i = 0; i < NumSpawns; ++i)
+	{
+		const float Z = 1.f - 2.f * (i + 0.5f) / NumSpawns;
+		const float RadiusXY = FMath::Sqrt(1.f - Z * Z);
+		const float Angle = GoldenAngle * i;
+		const FVector Normal(FMath::Cos(Angle) * RadiusXY, FMath::Sin(Angle) * RadiusXY, Z);
+		OutSpawns.Add(FHynmersTestSpawn(Center + Normal * Radius, Normal));
+	}
+}
+
+AHynmersCharacter* FHynmersMovementTestWorld::SpawnCharacter(const FHynmersTestSpawn& Spawn, bool bUseMovementManager)
+{
+	const FVector SpawnLocation = Spawn.Location + Spawn.UpVector * (CapsuleHalfHeight + 5.f);
+	const FQuat SpawnRotation = FMath::Abs(Spawn.Forward | Spawn.UpVector) < 0.99f ? FRotationMatrix::MakeFromZX(Spawn.UpVector, Spawn.Forward).ToQuat() : FRotationMatrix::MakeFromZ(Spawn.UpVector).ToQuat();
+	const FTransform Transform(SpawnRotation, SpawnLocation);
+
+	AHynmersCharacter* Character = World->SpawnActorDeferred<AHynmersCharacter>(AHynmersCharacter::StaticClass(), Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!Character)
+	{
+		return nullptr;
+	}
+
+	Character->AutoPossessPlayer = EAutoReceiveInput::Disabled;
+
+	UHynmersMovementComponent* MovementComponent = Cast<UHynmersMovementComponent>(Character->GetCharacterMovement());
+	MovementComponent->bRunPhysicsWithNoController = true;
+	MovementComponent->bUseMovementManager = bUseMovementManager;
+	// Scripted characters keep moving, sleeping would only measure the idle path
+	MovementComponent->bEnableSleeping = false;
+
+	Character->FinishSpawning(Transform);
+	return Character;
+}
+
+void FHynmersMovementTestWorld::Tick(float DeltaSeconds)
+{
+	World->Tick(LEVELTICK_All, DeltaSeconds);
+	GFrameCounter++;
+}
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AHynmersCharacter;
+class AHynmersStaticDistanceField;
+class AHynmersWaterBody;
+class APhysicsVolume;
+class AStaticMeshActor;
+class UStaticMesh;
+class UWorld;
+
+// Point on a surface where a character can stand
+struct FHynmersTestSpawn
+{
+	FVector Location;
+	FVector UpVector;
+	// Facing, projected on the surface
+	FVector Forward;
+
+	FHynmersTestSpawn(const FVector& InLocation, const FVector& InUpVector = FVector::UpVector, const FVector& InForward = FVector::ForwardVector)
+		: Location(InLocation)
+		, UpVector(InUpVector)
+		, Forward(InForward)
+	{
+	}
+};
+
+/*
+ * Standalone game world built from engine basic shapes, ticked manually.
+ * Used by the commandlets and automation tests to run the movement component without a map or a renderer.
+ */
+class MOVEMENTCOMPONENT_API FHynmersMovementTestWorld
+{
+public:
+	FHynmersMovementTestWorld();
+
+	~FHynmersMovementTestWorld();
+
+	bool Initialize();
+
+	void Shutdown();
+
+	UWorld* GetWorld() const { return World; }
+
+	// Geometry, static and blocking
+	AStaticMeshActor* AddBox(const FVector& Center, const FVector& Extent, const FRotator& Rotation = FRotator::ZeroRotator);
+
+	AStaticMeshActor* AddSphere(const FVector& Center, float Radius);
+
+	// Movable box spinning at RotationRate, a base characters have to follow
+	AStaticMeshActor* AddRotatingBox(const FVector& Center, const FVector& Extent, const FRotator& RotationRate);
+
+	// Water physics volume with a box brush
+	APhysicsVolume* AddWaterBox(const FVector& Center, const FVector& Extent);
+
+	// Water body with a box brush and the same box as closed form surface
+	AHynmersWaterBody* AddWaterBody(const FVector& Center, const FVector& Extent);
+
+	// Point gravity source pulling toward Center
+	void AddPointGravity(const FVector& Center, float InfluenceRadius, float Strength = 980.f);
+
+	// Distance field of the geometry added so far, baked when spawned
+	AHynmersStaticDistanceField* AddStaticDistanceField();
+
+	// Zones, each adds the spawns of its characters
+	void BuildFloor(const FVector& Origin, float HalfSize, TArray<FHynmersTestSpawn>& OutSpawns);
+
+	void BuildStairs(const FVector& Origin, int32 NumSteps, float StepHeight, float StepDepth, float Width, TArray<FHynmersTestSpawn>& OutSpawns);
+
+	void BuildRamps(const FVector& Origin, float Length, float Width, TArray<FHynmersTestSpawn>& OutSpawns);
+
+	void BuildCubePlanet(const FVector& Center, float HalfSize, TArray<FHynmersTestSpawn>& OutSpawns);
+
+	void BuildSpherePlanet(const FVector& Center, float Radius, TArray<FHynmersTestSpawn>& OutSpawns);
+
+	AHynmersCharacter* SpawnCharacter(const FHynmersTestSpawn& Spawn, bool bUseMovementManager);
+
+	void Tick(float DeltaSeconds);
+
+	// Character capsule, used to place spawns above the surfaces
+	static const float CapsuleRadius;
+	static const float CapsuleHalfHeight;
+
+private:
+	UWorld* World;
+
+	UStaticMesh* CubeMesh;
+
+	UStaticMesh* SphereMesh;
+};
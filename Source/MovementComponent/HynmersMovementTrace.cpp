@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementTrace.h"
+#include "HynmersMovementComponent.h"
+#include "HynmersMovementCoreRecorder.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/UObjectIterator.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHynmersMovementTrace, Log, All);
+
+int32 GHynmersMovementTraceEnabled = 1;
+static FAutoConsoleVariableRef CVarHynmersMovementTrace(
+	TEXT("Hynmers.MovementTrace"),
+	GHynmersMovementTraceEnabled,
+	TEXT("Record movement events in the per character trace buffers.\n")
+	TEXT("0: Disabled, 1: Enabled (default)"),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorldAndArgs CmdHynmersDumpMovementTrace(
+	TEXT("Hynmers.DumpMovementTrace"),
+	TEXT("Writes the movement trace of every character of the world to Saved/MovementTrace"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		FHynmersMovementTrace::DumpCharacters(World, TEXT("Command"));
+	}));
+
+static FAutoConsoleCommand CmdHynmersRecordCoreInputs(
+	TEXT("Hynmers.RecordCoreInputs"),
+	TEXT("Records the arguments of the HynmersMovementCore kernel calls for HynmersMovementMicro -Replay.\n")
+	TEXT("Hynmers.RecordCoreInputs [MaxCalls]: starts, default 1000000. Hynmers.RecordCoreInputs Stop: writes Saved/MovementBenchmark/CoreInputs-<date>.hmcore"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("Stop"))
+		{
+			const FString Filename = FPaths::ProjectSavedDir() / TEXT("MovementBenchmark") / FString::Printf(TEXT("CoreInputs-%s.hmcore"), *FDateTime::Now().ToString());
+			int32 NumCalls = 0;
+			if (FHynmersCoreRecorder::Stop(Filename, NumCalls))
+			{
+				UE_LOG(LogHynmersMovementTrace, Log, TEXT("%d core kernel calls written to %s"), NumCalls, *Filename);
+			}
+			else
+			{
+				UE_LOG(LogHynmersMovementTrace, Warning, TEXT("Could not write %d core kernel calls to %s"), NumCalls, *Filename);
+			}
+			return;
+		}
+
+		const int32 MaxCalls = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000000;
+		FHynmersCoreRecorder::Start(MaxCalls);
+		UE_LOG(LogHynmersMovementTrace, Log, TEXT("Recording up to %d core kernel calls"), MaxCalls);
+	}));
+
+namespace HynmersMovementTrace
+{
+	static const uint32 FileMagic = 0x52544D48; // HMTR
+	static const uint32 FileVersion = 1;
+
+	// Set by ensures that fired off the game thread, where iterating components and reading their buffers races with the tick
+	static FThreadSafeBool bEnsureDumpPending;
+}
+
+void FHynmersMovementTrace::GetRecords(TArray<FHynmersTraceRecord>& OutRecords) const
+{
+	const uint32 Written = (uint32)WriteIndex.GetValue();
+	const uint32 Num = FMath::Min<uint32>(Written, Capacity);
+
+	OutRecords.Reset(Num);
+	for (uint32 i = Written - Num; i < Written; ++i)
+	{
+		OutRecords.Add(Records[i & (Capacity - 1)]);
+	}
+}
+
+const TCHAR* FHynmersMovementTrace::GetEventName(uint8 Event)
+{
+	static const TCHAR* Names[] =
+	{
+		TEXT("None"),
+		TEXT("ModeChange"),
+		TEXT("StepUpAccepted"),
+		TEXT("StepUpRejected"),
+		TEXT("Landed"),
+		TEXT("Penetration"),
+		TEXT("IterationCap"),
+		TEXT("FloorLost"),
+		TEXT("Jump"),
+		TEXT("LedgeMove"),
+		TEXT("AdjustFloorHeight"),
+		TEXT("MoveSkipped"),
+		TEXT("RootMotion"),
+		TEXT("AirControlBoost"),
+	};
+	static_assert(ARRAY_COUNT(Names) == (int32)EHynmersTraceEvent::Num, "Event names out of date");
+
+	return Event < ARRAY_COUNT(Names) ? Names[Event] : TEXT("Unknown");
+}
+
+FString FHynmersMovementTrace::DumpCharacters(const UWorld* World, const TCHAR* Reason)
+{
+	TArray<FHynmersTraceDump> Dumps;
+	for (TObjectIterator<UHynmersMovementComponent> It; It; ++It)
+	{
+		if (It->IsTemplate() || (World && It->GetWorld() != World))
+		{
+			continue;
+		}
+
+		FHynmersTraceDump& Dump = Dumps[Dumps.AddDefaulted()];
+		Dump.Name = It->GetOwner() ? It->GetOwner()->GetName() : It->GetName();
+		It->GetMovementTrace().GetRecords(Dump.Records);
+	}
+
+	const FString Filename = FPaths::ProjectSavedDir() / TEXT("MovementTrace") / FString::Printf(TEXT("%s-%s.hmtrace"), Reason, *FDateTime::Now().ToString());
+	if (!SaveToFile(Filename, Dumps))
+	{
+		UE_LOG(LogHynmersMovementTrace, Warning, TEXT("Could not write movement trace %s"), *Filename);
+		return FString();
+	}
+
+	UE_LOG(LogHynmersMovementTrace, Log, TEXT("Movement trace of %d characters written to %s"), Dumps.Num(), *Filename);
+	return Filename;
+}
+
+bool FHynmersMovementTrace::SaveToFile(const FString& Filename, const TArray<FHynmersTraceDump>& Dumps)
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	uint32 Magic = HynmersMovementTrace::FileMagic;
+	uint32 Version = HynmersMovementTrace::FileVersion;
+	double SecondsPerCycle = FPlatformTime::GetSecondsPerCycle();
+	int32 NumDumps = Dumps.Num();
+	Writer << Magic << Version << SecondsPerCycle << NumDumps;
+
+	for (const FHynmersTraceDump& Dump : Dumps)
+	{
+		FString Name = Dump.Name;
+		int32 NumRecords = Dump.Records.Num();
+		Writer << Name << NumRecords;
+		for (FHynmersTraceRecord Record : Dump.Records)
+		{
+			Writer << Record;
+		}
+	}
+
+	return FFileHelper::SaveArrayToFile(Data, *Filename);
+}
+
+bool FHynmersMovementTrace::LoadFromFile(const FString& Filename, TArray<FHynmersTraceDump>& OutDumps, double& OutSecondsPerCycle)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int32 NumDumps = 0;
+	Reader << Magic << Version;
+	if (Magic != HynmersMovementTrace::FileMagic || Version != HynmersMovementTrace::FileVersion)
+	{
+		return false;
+	}
+	Reader << OutSecondsPerCycle << NumDumps;
+
+	OutDumps.Reset(NumDumps);
+	for (int32 i = 0; i < NumDumps && !Reader.IsError(); ++i)
+	{
+		FHynmersTraceDump& Dump = OutDumps[OutDumps.AddDefaulted()];
+		int32 NumRecords = 0;
+		Reader << Dump.Name << NumRecords;
+
+		Dump.Records.SetNumUninitialized(FMath::Clamp(NumRecords, 0, (int32)Capacity));
+		for (FHynmersTraceRecord& Record : Dump.Records)
+		{
+			Reader << Record;
+		}
+	}
+
+	return !Reader.IsError();
+}
+
+void FHynmersMovementTrace::OnSystemEnsure()
+{
+	if (!GHynmersMovementTraceEnabled)
+	{
+		return;
+	}
+
+	if (IsInGameThread())
+	{
+		DumpCharacters(nullptr, TEXT("Ensure"));
+	}
+	else
+	{
+		HynmersMovementTrace::bEnsureDumpPending = true;
+	}
+}
+
+void FHynmersMovementTrace::FlushPendingDump()
+{
+	if (HynmersMovementTrace::bEnsureDumpPending.AtomicSet(false))
+	{
+		DumpCharacters(nullptr, TEXT("Ensure"));
+	}
+}
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+
+// Hynmers.MovementTrace, recording is skipped when 0
+extern MOVEMENTCOMPONENT_API int32 GHynmersMovementTraceEnabled;
+
+enum class EHynmersTraceEvent : uint8
+{
+	None,
+	ModeChange,
+	StepUpAccepted,
+	StepUpRejected,
+	Landed,
+	Penetration,
+	IterationCap,
+	FloorLost,
+	Jump,
+	LedgeMove,
+	AdjustFloorHeight,
+	MoveSkipped,
+	RootMotion,
+	AirControlBoost,
+	Num
+};
+
+struct FHynmersTraceRecord
+{
+	uint32 Cycles;
+	uint32 Frame;
+	uint8 Event;
+	uint8 MovementMode;
+	uint16 Param;
+	float Value;
+	FVector Vector;
+
+	friend FArchive& operator<<(FArchive& Ar, FHynmersTraceRecord& Record)
+	{
+		Ar << Record.Cycles << Record.Frame << Record.Event << Record.MovementMode << Record.Param << Record.Value << Record.Vector;
+		return Ar;
+	}
+};
+
+// Records of one character, as stored in a dump file
+struct FHynmersTraceDump
+{
+	FString Name;
+	TArray<FHynmersTraceRecord> Records;
+};
+
+/*
+ * Fixed size ring buffer of typed movement events.
+ * Recording is a counter increment and a few stores, no formatting and no locks. Old events are overwritten.
+ */
+class MOVEMENTCOMPONENT_API FHynmersMovementTrace
+{
+public:
+	enum { Capacity = 256 };
+
+	FORCEINLINE void Record(EHynmersTraceEvent Event, uint8 MovementMode, const FVector& Vector = FVector::ZeroVector, float Value = 0.f, uint16 Param = 0)
+	{
+		if (!GHynmersMovementTraceEnabled)
+		{
+			return;
+		}
+
+		const uint32 Index = (uint32)WriteIndex.Increment() - 1;
+		FHynmersTraceRecord& Record = Records[Index & (Capacity - 1)];
+		Record.Cycles = FPlatformTime::Cycles();
+		Record.Frame = (uint32)GFrameCounter;
+		Record.Event = (uint8)Event;
+		Record.MovementMode = MovementMode;
+		Record.Param = Param;
+		Record.Value = Value;
+		Record.Vector = Vector;
+	}
+
+	// Records from the oldest to the newest
+	void GetRecords(TArray<FHynmersTraceRecord>& OutRecords) const;
+
+	void Reset() { WriteIndex.Reset(); }
+
+	static const TCHAR* GetEventName(uint8 Event);
+
+	// Writes the traces of every character of the world, or of every world when null. Returns the file written.
+	static FString DumpCharacters(const UWorld* World, const TCHAR* Reason);
+
+	static bool SaveToFile(const FString& Filename, const TArray<FHynmersTraceDump>& Dumps);
+
+	static bool LoadFromFile(const FString& Filename, TArray<FHynmersTraceDump>& OutDumps, double& OutSecondsPerCycle);
+
+	// Bound to FCoreDelegates::OnHandleSystemEnsure by the module. Off the game thread the dump waits for FlushPendingDump.
+	static void OnSystemEnsure();
+
+	// Bound to FCoreDelegates::OnEndFrame by the module
+	static void FlushPendingDump();
+
+private:
+	FHynmersTraceRecord Records[Capacity];
+
+	FThreadSafeCounter WriteIndex;
+};
@@ -0,0 +1,183 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersNetQuantize.h"
+
+namespace HynmersNetQuantize
+{
+	static const float VelocityScale = 1.f;
+	static const float AccelerationScale = 10.f;
+
+	static float SignNotZero(float Value)
+	{
+		return Value >= 0.f ? 1.f : -1.f;
+	}
+
+	uint32 PackUnitVector(const FVector& Normal)
+	{
+		const float L1Norm = FMath::Abs(Normal.X) + FMath::Abs(Normal.Y) + FMath::Abs(Normal.Z);
+		if (L1Norm < KINDA_SMALL_NUMBER)
+		{
+			return PackUnitVector(FVector::UpVector);
+		}
+
+		// Project on the octahedron and fold the lower hemisphere over the upper one
+		float U = Normal.X / L1Norm;
+		float V = Normal.Y / L1Norm;
+		if (Normal.Z < 0.f)
+		{
+			const float FoldedU = (1.f - FMath::Abs(V)) * SignNotZero(U);
+			const float FoldedV = (1.f - FMath::Abs(U)) * SignNotZero(V);
+			U = FoldedU;
+			V = FoldedV;
+		}
+
+		const uint32 MaxValue = (1u << UnitVectorBits) - 1;
+		const uint32 QuantizedU = (uint32)FMath::Clamp(FMath::RoundToInt((U * 0.5f + 0.5f) * MaxValue), 0, (int32)MaxValue);
+		const uint32 QuantizedV = (uint32)FMath::Clamp(FMath::RoundToInt((V * 0.5f + 0.5f) * MaxValue), 0, (int32)MaxValue);
+		return QuantizedU | (QuantizedV << UnitVectorBits);
+	}
+
+	FVector UnpackUnitVector(uint32 Packed)
+	{
+		const uint32 MaxValue = (1u << UnitVectorBits) - 1;
+		const float U = (float)(Packed & MaxValue) / MaxValue * 2.f - 1.f;
+		const float V = (float)((Packed >> UnitVectorBits) & MaxValue) / MaxValue * 2.f - 1.f;
+
+		FVector Normal(U, V, 1.f - FMath::Abs(U) - FMath::Abs(V));
+		if (Normal.Z < 0.f)
+		{
+			Normal.X = (1.f - FMath::Abs(V)) * SignNotZero(U);
+			Normal.Y = (1.f - FMath::Abs(U)) * SignNotZero(V);
+		}
+		return Normal.GetSafeNormal();
+	}
+
+	void GetTangentFrame(const FVector& Up, FVector& OutTangentX, FVector& OutTangentY)
+	{
+		const FVector Reference = FMath::Abs(Up.Z) < 0.9f ? FVector::UpVector : FVector::ForwardVector;
+		OutTangentY = FVector::CrossProduct(Up, Reference).GetSafeNormal();
+		OutTangentX = FVector::CrossProduct(OutTangentY, Up);
+	}
+
+	static int32 QuantizeComponent(float Value, float Scale)
+	{
+		return FMath::Clamp(FMath::RoundToInt(Value * Scale), (int32)MIN_int16, (int32)MAX_int16);
+	}
+
+	void PackTangentVector(const FVector& Vector, const FVector& Up, float Scale, int32& OutTangentX, int32& OutTangentY, int32& OutNormal)
+	{
+		FVector TangentX, TangentY;
+		GetTangentFrame(Up, TangentX, TangentY);
+
+		OutTangentX = QuantizeComponent(Vector | TangentX, Scale);
+		OutTangentY = QuantizeComponent(Vector | TangentY, Scale);
+		OutNormal = QuantizeComponent(Vector | Up, Scale);
+	}
+
+	FVector UnpackTangentVector(int32 TangentX, int32 TangentY, int32 Normal, const FVector& Up, float Scale)
+	{
+		FVector AxisX, AxisY;
+		GetTangentFrame(Up, AxisX, AxisY);
+
+		const float InvScale = 1.f / Scale;
+		return (AxisX * TangentX + AxisY * TangentY + Up * Normal) * InvScale;
+	}
+
+	uint16 PackYaw(const FQuat& Rotation, const FVector& Up)
+	{
+		FVector TangentX, TangentY;
+		GetTangentFrame(Up, TangentX, TangentY);
+
+		const FVector Forward = Rotation.GetForwardVector();
+		const float Yaw = FMath::RadiansToDegrees(FMath::Atan2(Forward | TangentY, Forward | TangentX));
+		return FRotator::CompressAxisToShort(Yaw);
+	}
+
+	FQuat UnpackYaw(uint16 PackedYaw, const FVector& Up)
+	{
+		FVector TangentX, TangentY;
+		GetTangentFrame(Up, TangentX, TangentY);
+
+		float Sin, Cos;
+		FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(FRotator::DecompressAxisFromShort(PackedYaw)));
+		return FRotationMatrix::MakeFromZX(Up, TangentX * Cos + TangentY * Sin).ToQuat();
+	}
+
+	void SerializeSigned16(FArchive& Ar, int32& Value, bool bOptional)
+	{
+		if (bOptional)
+		{
+			uint8 bHasValue = Value != 0;
+			Ar.SerializeBits(&bHasValue, 1);
+			if (!bHasValue)
+			{
+				Value = 0;
+				return;
+			}
+		}
+
+		uint32 Biased = (uint32)(FMath::Clamp(Value, (int32)MIN_int16, (int32)MAX_int16) + 32768);
+		Ar.SerializeInt(Biased, 65536);
+		Value = (int32)Biased - 32768;
+	}
+}
+
+void FHynmersPackedMovement::Pack(const FVector& InLocation, const FQuat& InRotation, const FVector& InVelocity)
+{
+	Location = InLocation;
+	PackedUpVector = HynmersNetQuantize::PackUnitVector(InRotation.GetUpVector());
+
+	// Receivers only know the quantized up vector, use the same frame here
+	const FVector UpVector = HynmersNetQuantize::UnpackUnitVector(PackedUpVector);
+	PackedYaw = HynmersNetQuantize::PackYaw(InRotation, UpVector);
+	HynmersNetQuantize::PackTangentVector(InVelocity, UpVector, HynmersNetQuantize::VelocityScale, TangentVelocityX, TangentVelocityY, NormalVelocity);
+}
+
+void FHynmersPackedMovement::Unpack(FVector& OutLocation, FQuat& OutRotation, FVector& OutVelocity, FVector& OutUpVector) const
+{
+	OutUpVector = HynmersNetQuantize::UnpackUnitVector(PackedUpVector);
+	OutLocation = Location;
+	OutRotation = HynmersNetQuantize::UnpackYaw(PackedYaw, OutUpVector);
+	OutVelocity = HynmersNetQuantize::UnpackTangentVector(TangentVelocityX, TangentVelocityY, NormalVelocity, OutUpVector, HynmersNetQuantize::VelocityScale);
+}
+
+bool FHynmersPackedMovement::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bool bLocationSuccess = true;
+	Location.NetSerialize(Ar, Map, bLocationSuccess);
+
+	Ar.SerializeInt(PackedUpVector, 1u << (2 * HynmersNetQuantize::UnitVectorBits));
+	Ar << PackedYaw;
+
+	HynmersNetQuantize::SerializeSigned16(Ar, TangentVelocityX);
+	HynmersNetQuantize::SerializeSigned16(Ar, TangentVelocityY);
+	// Walking velocity lies on the tangent plane
+	HynmersNetQuantize::SerializeSigned16(Ar, NormalVelocity, true);
+
+	bOutSuccess = bLocationSuccess && !Ar.IsError();
+	return true;
+}
+
+void FHynmersPackedAcceleration::Pack(const FVector& Acceleration, const FVector& UpVector)
+{
+	PackedUpVector = HynmersNetQuantize::PackUnitVector(UpVector);
+	HynmersNetQuantize::PackTangentVector(Acceleration, HynmersNetQuantize::UnpackUnitVector(PackedUpVector), HynmersNetQuantize::AccelerationScale, TangentX, TangentY, Normal);
+}
+
+FVector FHynmersPackedAcceleration::Unpack() const
+{
+	return HynmersNetQuantize::UnpackTangentVector(TangentX, TangentY, Normal, HynmersNetQuantize::UnpackUnitVector(PackedUpVector), HynmersNetQuantize::AccelerationScale);
+}
+
+bool FHynmersPackedAcceleration::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar.SerializeInt(PackedUpVector, 1u << (2 * HynmersNetQuantize::UnitVectorBits));
+
+	HynmersNetQuantize::SerializeSigned16(Ar, TangentX);
+	HynmersNetQuantize::SerializeSigned16(Ar, TangentY);
+	// Input acceleration is constrained to the tangent plane
+	HynmersNetQuantize::SerializeSigned16(Ar, Normal, true);
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
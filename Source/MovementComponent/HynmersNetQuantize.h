@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "HynmersNetQuantize.generated.h"
+
+/*
+ * Quantization of movement state relative to the gravity frame.
+ * The up vector goes as an octahedral normal and vectors lying on the tangent plane
+ * as two components in a tangent frame that only depends on the up vector.
+ */
+namespace HynmersNetQuantize
+{
+	// Bits per octahedral component, 22 bits per up vector
+	static const int32 UnitVectorBits = 11;
+
+	MOVEMENTCOMPONENT_API uint32 PackUnitVector(const FVector& Normal);
+
+	MOVEMENTCOMPONENT_API FVector UnpackUnitVector(uint32 Packed);
+
+	// Orthonormal tangents of Up, identical on every machine for the same Up
+	MOVEMENTCOMPONENT_API void GetTangentFrame(const FVector& Up, FVector& OutTangentX, FVector& OutTangentY);
+
+	// Vector as tangent and normal components, in units of 1/Scale, clamped to 16 bits
+	MOVEMENTCOMPONENT_API void PackTangentVector(const FVector& Vector, const FVector& Up, float Scale, int32& OutTangentX, int32& OutTangentY, int32& OutNormal);
+
+	MOVEMENTCOMPONENT_API FVector UnpackTangentVector(int32 TangentX, int32 TangentY, int32 Normal, const FVector& Up, float Scale);
+
+	// Heading of the rotation around Up, relative to the tangent frame
+	MOVEMENTCOMPONENT_API uint16 PackYaw(const FQuat& Rotation, const FVector& Up);
+
+	MOVEMENTCOMPONENT_API FQuat UnpackYaw(uint16 PackedYaw, const FVector& Up);
+
+	// Signed value in 16 bits, plus a bit telling if it is zero when bOptional
+	MOVEMENTCOMPONENT_API void SerializeSigned16(FArchive& Ar, int32& Value, bool bOptional = false);
+}
+
+/*
+ * Replicated movement of simulated proxies, replaces FRepMovement for non physics characters.
+ */
+USTRUCT()
+struct MOVEMENTCOMPONENT_API FHynmersPackedMovement
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		FVector_NetQuantize100 Location;
+
+	UPROPERTY()
+		uint32 PackedUpVector = 0;
+
+	UPROPERTY()
+		uint16 PackedYaw = 0;
+
+	// Velocity in cm/s, the normal component is only sent while it is not zero
+	UPROPERTY()
+		int32 TangentVelocityX = 0;
+
+	UPROPERTY()
+		int32 TangentVelocityY = 0;
+
+	UPROPERTY()
+		int32 NormalVelocity = 0;
+
+	void Pack(const FVector& InLocation, const FQuat& InRotation, const FVector& InVelocity);
+
+	void Unpack(FVector& OutLocation, FQuat& OutRotation, FVector& OutVelocity, FVector& OutUpVector) const;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FHynmersPackedMovement> : public TStructOpsTypeTraitsBase2<FHynmersPackedMovement>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/*
+ * Input acceleration of a client move, relative to the up vector the client used.
+ */
+USTRUCT()
+struct MOVEMENTCOMPONENT_API FHynmersPackedAcceleration
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		uint32 PackedUpVector = 0;
+
+	// Acceleration in 0.1 cm/s^2
+	UPROPERTY()
+		int32 TangentX = 0;
+
+	UPROPERTY()
+		int32 TangentY = 0;
+
+	UPROPERTY()
+		int32 Normal = 0;
+
+	void Pack(const FVector& Acceleration, const FVector& UpVector);
+
+	FVector Unpack() const;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FHynmersPackedAcceleration> : public TStructOpsTypeTraitsBase2<FHynmersPackedAcceleration>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
@@ -0,0 +1,593 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersStaticDistanceField.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHynmersDistanceField, Log, All);
+
+namespace HynmersDistanceField
+{
+	static TMap<TWeakObjectPtr<const UWorld>, TWeakObjectPtr<AHynmersStaticDistanceField>> WorldFields;
+
+	// Dense brick grids above this size are not baked
+	static const int64 MaxGridBricks = 1 << 24;
+
+	// Gap under which the swept sphere touches the surface
+	static const float ContactTolerance = 0.1f;
+
+	static const int32 MaxSweepSteps = 32;
+
+	// Deviation from the plane of a brick under which its samples still measure that plane
+	static const float PlanarTolerance = 0.05f;
+
+	// Movables spanning more cells go to the large list
+	static const int32 MaxMovableCells = 64;
+}
+
+AHynmersStaticDistanceField::AHynmersStaticDistanceField()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+}
+
+void AHynmersStaticDistanceField::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	HynmersDistanceField::WorldFields.Add(GetWorld(), this);
+}
+
+void AHynmersStaticDistanceField::BeginPlay()
+{
+	Super::BeginPlay();
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &AHynmersStaticDistanceField::OnLevelChanged);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &AHynmersStaticDistanceField::OnLevelChanged);
+	PhysicsCreatedHandle = UActorComponent::GlobalCreatePhysicsDelegate.AddUObject(this, &AHynmersStaticDistanceField::OnPhysicsStateCreated);
+	PhysicsDestroyedHandle = UActorComponent::GlobalDestroyPhysicsDelegate.AddUObject(this, &AHynmersStaticDistanceField::OnPhysicsStateDestroyed);
+
+	Bake();
+}
+
+void AHynmersStaticDistanceField::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	UActorComponent::GlobalCreatePhysicsDelegate.Remove(PhysicsCreatedHandle);
+	UActorComponent::GlobalDestroyPhysicsDelegate.Remove(PhysicsDestroyedHandle);
+
+	const TWeakObjectPtr<AHynmersStaticDistanceField>* Registered = HynmersDistanceField::WorldFields.Find(GetWorld());
+	if (Registered && Registered->Get() == this)
+	{
+		HynmersDistanceField::WorldFields.Remove(GetWorld());
+	}
+
+	Invalidate();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+AHynmersStaticDistanceField* AHynmersStaticDistanceField::Find(const UWorld* World)
+{
+	// Only written on the game thread when a field begins or ends play, safe to read from the movement worker threads
+	const TWeakObjectPtr<AHynmersStaticDistanceField>* Registered = World ? HynmersDistanceField::WorldFields.Find(World) : nullptr;
+	return Registered ? Registered->Get() : nullptr;
+}
+
+void AHynmersStaticDistanceField::Invalidate()
+{
+	bBaked = false;
+	BrickIndices.Empty();
+	Bricks.Empty();
+	Components.Empty();
+	ComponentBounds.Empty();
+	ComponentIndices.Empty();
+	ReleasedComponents.Empty();
+	Movables.Empty();
+	MovableCells.Empty();
+	LargeMovables.Empty();
+	MovablesFrame = MAX_uint64;
+}
+
+void AHynmersStaticDistanceField::OnLevelChanged(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	Invalidate();
+	if (bRebakeOnLevelChange)
+	{
+		Bake();
+	}
+}
+
+void AHynmersStaticDistanceField::Bake()
+{
+	using namespace HynmersDistanceField;
+
+	Invalidate();
+
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Static geometry blocking the characters
+	Bounds.Init();
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		TInlineComponentArray<UPrimitiveComponent*> Primitives(*It);
+		for (UPrimitiveComponent* Primitive : Primitives)
+		{
+			if (Primitive->IsRegistered() && Primitive->Mobility == EComponentMobility::Static && Primitive->IsQueryCollisionEnabled()
+				&& Primitive->GetCollisionResponseToChannel(CollisionChannel) == ECR_Block)
+			{
+				ComponentIndices.Add(Primitive, Components.Add(Primitive));
+				ComponentBounds.Add(Primitive->Bounds.GetBox());
+				Bounds += ComponentBounds.Last();
+			}
+		}
+		AddMovables(*It);
+	}
+
+	if (Components.Num() == 0 || Components.Num() >= NoComponent)
+	{
+		UE_LOG(LogHynmersDistanceField, Warning, TEXT("%s: %d static components, nothing baked"), *GetName(), Components.Num());
+		Components.Empty();
+		ComponentBounds.Empty();
+		ComponentIndices.Empty();
+		return;
+	}
+
+	const float BrickWorldSize = VoxelSize * BrickSize;
+	// Bricks whose corners are all farther than this are empty, whatever the distance inside them
+	const float KeepDistance = MaxDistance + VoxelSize * HALF_SQRT_3;
+
+	Bounds = Bounds.ExpandBy(MaxDistance);
+	const FVector Size = Bounds.GetSize();
+	NumBricks = FIntVector(FMath::CeilToInt(Size.X / BrickWorldSize), FMath::CeilToInt(Size.Y / BrickWorldSize), FMath::CeilToInt(Size.Z / BrickWorldSize));
+	const int64 NumGridBricks = (int64)NumBricks.X * NumBricks.Y * NumBricks.Z;
+	if (NumGridBricks > MaxGridBricks)
+	{
+		UE_LOG(LogHynmersDistanceField, Warning, TEXT("%s: %lld bricks needed, increase VoxelSize"), *GetName(), NumGridBricks);
+		Components.Empty();
+		ComponentBounds.Empty();
+		ComponentIndices.Empty();
+		return;
+	}
+
+	// Candidate components of every brick close to one
+	TMap<int32, TArray<int32>> BrickCandidates;
+	for (int32 ComponentIndex = 0; ComponentIndex < ComponentBounds.Num(); ++ComponentIndex)
+	{
+		const FBox Box = ComponentBounds[ComponentIndex].ExpandBy(KeepDistance);
+		const FIntVector Min(
+			FMath::Max(FMath::FloorToInt((Box.Min.X - Bounds.Min.X) / BrickWorldSize), 0),
+			FMath::Max(FMath::FloorToInt((Box.Min.Y - Bounds.Min.Y) / BrickWorldSize), 0),
+			FMath::Max(FMath::FloorToInt((Box.Min.Z - Bounds.Min.Z) / BrickWorldSize), 0));
+		const FIntVector Max(
+			FMath::Min(FMath::FloorToInt((Box.Max.X - Bounds.Min.X) / BrickWorldSize), NumBricks.X - 1),
+			FMath::Min(FMath::FloorToInt((Box.Max.Y - Bounds.Min.Y) / BrickWorldSize), NumBricks.Y - 1),
+			FMath::Min(FMath::FloorToInt((Box.Max.Z - Bounds.Min.Z) / BrickWorldSize), NumBricks.Z - 1));
+
+		for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+		{
+			for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+			{
+				for (int32 X = Min.X; X <= Max.X; ++X)
+				{
+					BrickCandidates.FindOrAdd(X + (Y + Z * NumBricks.Y) * NumBricks.X).Add(ComponentIndex);
+				}
+			}
+		}
+	}
+
+	TArray<int32> BrickCells;
+	TArray<const TArray<int32>*> CellCandidates;
+	BrickCells.Reserve(BrickCandidates.Num());
+	CellCandidates.Reserve(BrickCandidates.Num());
+	for (const TPair<int32, TArray<int32>>& Pair : BrickCandidates)
+	{
+		BrickCells.Add(Pair.Key);
+		CellCandidates.Add(&Pair.Value);
+	}
+
+	// Distance queries only read the physics scene, bricks are baked in parallel
+	TArray<FBrick> BakedBricks;
+	TArray<int32> BrickStates;
+	BakedBricks.SetNumUninitialized(BrickCells.Num());
+	BrickStates.SetNumUninitialized(BrickCells.Num());
+	const FIntVector GridSize = NumBricks;
+	ParallelFor(BrickCells.Num(), [this, &BrickCells, &CellCandidates, &BakedBricks, &BrickStates, &GridSize](int32 Index)
+	{
+		const int32 Cell = BrickCells[Index];
+		const FIntVector BrickCoord(Cell % GridSize.X, (Cell / GridSize.X) % GridSize.Y, Cell / (GridSize.X * GridSize.Y));
+		BrickStates[Index] = BakeBrick(BrickCoord, *CellCandidates[Index], BakedBricks[Index]);
+	});
+
+	BrickIndices.Init(EmptyBrick, (int32)NumGridBricks);
+	int32 NumAmbiguous = 0;
+	int32 NumCurved = 0;
+	for (int32 Index = 0; Index < BrickCells.Num(); ++Index)
+	{
+		if (BrickStates[Index] == AmbiguousBrick)
+		{
+			BrickIndices[BrickCells[Index]] = AmbiguousBrick;
+			++NumAmbiguous;
+		}
+		else if (BrickStates[Index] != EmptyBrick)
+		{
+			BrickIndices[BrickCells[Index]] = Bricks.Add(BakedBricks[Index]);
+			NumCurved += BakedBricks[Index].bPlanar ? 0 : 1;
+		}
+	}
+
+	ReleasedComponents.Init(false, Components.Num());
+	bBaked = true;
+
+	UE_LOG(LogHynmersDistanceField, Display, TEXT("%s: baked %d bricks (%.1f MB) from %d static components in %.2f s, %d ambiguous and %d non planar bricks"),
+		*GetName(), Bricks.Num(), (Bricks.Num() * sizeof(FBrick) + BrickIndices.Num() * sizeof(int32)) / (1024.f * 1024.f),
+		Components.Num(), FPlatformTime::Seconds() - StartTime, NumAmbiguous, NumCurved);
+}
+
+void AHynmersStaticDistanceField::OnPhysicsStateCreated(UActorComponent* Component)
+{
+	UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+	if (!bBaked || !Primitive || Primitive->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	// Registered again as static where it was baked, the field is right about it again
+	const int32* BakedIndex = ComponentIndices.Find(Primitive);
+	if (BakedIndex && Primitive->Mobility == EComponentMobility::Static && Primitive->Bounds.GetBox() == ComponentBounds[*BakedIndex])
+	{
+		ReleasedComponents[*BakedIndex] = false;
+		return;
+	}
+
+	// The field knows nothing registered after the bake, static or not
+	Movables.Add(Primitive);
+}
+
+void AHynmersStaticDistanceField::OnPhysicsStateDestroyed(UActorComponent* Component)
+{
+	UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+	if (!bBaked || !Primitive || Primitive->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	// Removed, or reregistered to change its mobility. One coming back unchanged is restored by OnPhysicsStateCreated.
+	if (const int32* BakedIndex = ComponentIndices.Find(Primitive))
+	{
+		ReleasedComponents[*BakedIndex] = true;
+	}
+	Movables.Remove(Primitive);
+}
+
+void AHynmersStaticDistanceField::AddMovables(AActor* Actor)
+{
+	TInlineComponentArray<UPrimitiveComponent*> Primitives(Actor);
+	for (UPrimitiveComponent* Primitive : Primitives)
+	{
+		if (Primitive->Mobility != EComponentMobility::Static)
+		{
+			Movables.Add(Primitive);
+		}
+	}
+}
+
+void AHynmersStaticDistanceField::UpdateMovables()
+{
+	using namespace HynmersDistanceField;
+
+	check(IsInGameThread());
+	if (MovablesFrame == GFrameCounter)
+	{
+		return;
+	}
+	MovablesFrame = GFrameCounter;
+
+	MovableCells.Reset();
+	LargeMovables.Reset();
+
+	for (auto It = Movables.CreateIterator(); It; ++It)
+	{
+		UPrimitiveComponent* Primitive = It->Get();
+		if (!Primitive)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		if (!Primitive->IsRegistered() || !Primitive->IsQueryCollisionEnabled() || Primitive->GetCollisionResponseToChannel(CollisionChannel) != ECR_Block)
+		{
+			continue;
+		}
+
+		// Swept over the lookahead, queries read the current bounds again
+		const FBox Box = Primitive->Bounds.GetBox();
+		const FVector Motion = Primitive->GetComponentVelocity() * MovableLookahead;
+		const FBox SweptBox = (Box + Box.ShiftBy(Motion)).ExpandBy(KINDA_SMALL_NUMBER);
+		const FIntVector Min(FMath::FloorToInt(SweptBox.Min.X / MovableCellSize), FMath::FloorToInt(SweptBox.Min.Y / MovableCellSize), FMath::FloorToInt(SweptBox.Min.Z / MovableCellSize));
+		const FIntVector Max(FMath::FloorToInt(SweptBox.Max.X / MovableCellSize), FMath::FloorToInt(SweptBox.Max.Y / MovableCellSize), FMath::FloorToInt(SweptBox.Max.Z / MovableCellSize));
+		const int64 NumCells = (int64)(Max.X - Min.X + 1) * (Max.Y - Min.Y + 1) * (Max.Z - Min.Z + 1);
+		if (NumCells > MaxMovableCells)
+		{
+			LargeMovables.Add(Primitive);
+			continue;
+		}
+
+		for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+		{
+			for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+			{
+				for (int32 X = Min.X; X <= Max.X; ++X)
+				{
+					MovableCells.FindOrAdd(FIntVector(X, Y, Z)).Add(Primitive);
+				}
+			}
+		}
+	}
+}
+
+bool AHynmersStaticDistanceField::OverlapsMovable(const FBox& Box, const AActor* IgnoreActor) const
+{
+	auto Overlaps = [&Box, IgnoreActor](const UPrimitiveComponent* Primitive)
+	{
+		return Primitive->GetOwner() != IgnoreActor && Primitive->Bounds.GetBox().Intersect(Box);
+	};
+
+	for (const UPrimitiveComponent* Primitive : LargeMovables)
+	{
+		if (Overlaps(Primitive))
+		{
+			return true;
+		}
+	}
+
+	const FIntVector Min(FMath::FloorToInt(Box.Min.X / MovableCellSize), FMath::FloorToInt(Box.Min.Y / MovableCellSize), FMath::FloorToInt(Box.Min.Z / MovableCellSize));
+	const FIntVector Max(FMath::FloorToInt(Box.Max.X / MovableCellSize), FMath::FloorToInt(Box.Max.Y / MovableCellSize), FMath::FloorToInt(Box.Max.Z / MovableCellSize));
+	for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+		{
+			for (int32 X = Min.X; X <= Max.X; ++X)
+			{
+				const TArray<UPrimitiveComponent*>* Cell = MovableCells.Find(FIntVector(X, Y, Z));
+				if (Cell && Cell->ContainsByPredicate(Overlaps))
+				{
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+int32 AHynmersStaticDistanceField::BakeBrick(const FIntVector& BrickCoord, const TArray<int32>& Candidates, FBrick& OutBrick) const
+{
+	using namespace HynmersDistanceField;
+
+	const float BrickWorldSize = VoxelSize * BrickSize;
+	const float KeepDistance = MaxDistance + VoxelSize * HALF_SQRT_3;
+	const FVector BrickOrigin = Bounds.Min + FVector(BrickCoord) * BrickWorldSize;
+
+	bool bKeep = false;
+
+	// Plane of the first sample off the surface, every other sample has to measure the same distance to it
+	bool bHasPlane = false;
+	FVector PlanePoint = FVector::ZeroVector;
+	FVector PlaneNormal = FVector::ZeroVector;
+	OutBrick.bPlanar = true;
+
+	for (int32 Z = 0; Z < BrickSamples; ++Z)
+	{
+		for (int32 Y = 0; Y < BrickSamples; ++Y)
+		{
+			for (int32 X = 0; X < BrickSamples; ++X)
+			{
+				const FVector Point = BrickOrigin + FVector(X, Y, Z) * VoxelSize;
+
+				float BestDistance = KeepDistance;
+				uint16 BestComponent = NoComponent;
+				FVector BestPoint = FVector::ZeroVector;
+				for (int32 ComponentIndex : Candidates)
+				{
+					const UPrimitiveComponent* Primitive = Components[ComponentIndex].Get();
+					FVector ClosestPoint;
+					const float Distance = Primitive ? Primitive->GetDistanceToCollision(Point, ClosestPoint) : -1.f;
+					if (Distance < 0.f)
+					{
+						// Shape without a distance query
+						return AmbiguousBrick;
+					}
+					if (Distance < BestDistance)
+					{
+						BestDistance = Distance;
+						BestComponent = (uint16)ComponentIndex;
+						BestPoint = ClosestPoint;
+					}
+				}
+
+				bKeep |= BestDistance < KeepDistance;
+
+				// Samples inside the collision or clamped at MaxDistance measure nothing
+				if (OutBrick.bPlanar && BestDistance > KINDA_SMALL_NUMBER && BestDistance < MaxDistance)
+				{
+					if (!bHasPlane)
+					{
+						bHasPlane = true;
+						PlanePoint = BestPoint;
+						PlaneNormal = (Point - BestPoint) / BestDistance;
+					}
+					else
+					{
+						OutBrick.bPlanar = FMath::Abs(((Point - PlanePoint) | PlaneNormal) - BestDistance) <= PlanarTolerance;
+					}
+				}
+
+				const int32 Sample = X + (Y + Z * BrickSamples) * BrickSamples;
+				OutBrick.Distance[Sample] = (uint16)FMath::RoundToInt(FMath::Min(BestDistance / MaxDistance, 1.f) * MAX_uint16);
+				OutBrick.Component[Sample] = BestComponent;
+			}
+		}
+	}
+
+	return bKeep ? 0 : EmptyBrick;
+}
+
+bool AHynmersStaticDistanceField::LookupSample(const FVector& Point, float& OutDistance, uint16& OutComponent) const
+{
+	const FVector Local = (Point - Bounds.Min) / VoxelSize;
+	const FIntVector Voxel(FMath::FloorToInt(Local.X), FMath::FloorToInt(Local.Y), FMath::FloorToInt(Local.Z));
+	const FIntVector BrickCoord(Voxel.X / BrickSize, Voxel.Y / BrickSize, Voxel.Z / BrickSize);
+
+	// The bounds include MaxDistance around the collision
+	if (Voxel.X < 0 || Voxel.Y < 0 || Voxel.Z < 0 || BrickCoord.X >= NumBricks.X || BrickCoord.Y >= NumBricks.Y || BrickCoord.Z >= NumBricks.Z)
+	{
+		OutDistance = MaxDistance;
+		OutComponent = NoComponent;
+		return true;
+	}
+
+	const int32 BrickIndex = BrickIndices[BrickCoord.X + (BrickCoord.Y + BrickCoord.Z * NumBricks.Y) * NumBricks.X];
+	if (BrickIndex == AmbiguousBrick)
+	{
+		return false;
+	}
+	if (BrickIndex == EmptyBrick)
+	{
+		OutDistance = MaxDistance;
+		OutComponent = NoComponent;
+		return true;
+	}
+
+	const FBrick& Brick = Bricks[BrickIndex];
+	const int32 DY = BrickSamples;
+	const int32 DZ = BrickSamples * BrickSamples;
+	const int32 Base = (Voxel.X - BrickCoord.X * BrickSize) + (Voxel.Y - BrickCoord.Y * BrickSize) * DY + (Voxel.Z - BrickCoord.Z * BrickSize) * DZ;
+	const float FX = Local.X - Voxel.X;
+	const float FY = Local.Y - Voxel.Y;
+	const float FZ = Local.Z - Voxel.Z;
+
+	const uint16* D = Brick.Distance;
+	const float D00 = FMath::Lerp<float>(D[Base], D[Base + 1], FX);
+	const float D10 = FMath::Lerp<float>(D[Base + DY], D[Base + DY + 1], FX);
+	const float D01 = FMath::Lerp<float>(D[Base + DZ], D[Base + DZ + 1], FX);
+	const float D11 = FMath::Lerp<float>(D[Base + DY + DZ], D[Base + DY + DZ + 1], FX);
+	const float Quantized = FMath::Lerp(FMath::Lerp(D00, D10, FY), FMath::Lerp(D01, D11, FY), FZ);
+
+	OutDistance = Quantized * (MaxDistance / MAX_uint16);
+	OutComponent = Brick.Component[Base + (FX > 0.5f ? 1 : 0) + (FY > 0.5f ? DY : 0) + (FZ > 0.5f ? DZ : 0)];
+	return true;
+}
+
+bool AHynmersStaticDistanceField::IsPlanarAt(const FVector& Point) const
+{
+	const FVector Local = (Point - Bounds.Min) / (VoxelSize * BrickSize);
+	const FIntVector BrickCoord(FMath::FloorToInt(Local.X), FMath::FloorToInt(Local.Y), FMath::FloorToInt(Local.Z));
+	if (BrickCoord.X < 0 || BrickCoord.Y < 0 || BrickCoord.Z < 0 || BrickCoord.X >= NumBricks.X || BrickCoord.Y >= NumBricks.Y || BrickCoord.Z >= NumBricks.Z)
+	{
+		return false;
+	}
+
+	const int32 BrickIndex = BrickIndices[BrickCoord.X + (BrickCoord.Y + BrickCoord.Z * NumBricks.Y) * NumBricks.X];
+	return BrickIndex >= 0 && Bricks[BrickIndex].bPlanar;
+}
+
+bool AHynmersStaticDistanceField::SampleDistance(const FVector& Point, float& OutDistance) const
+{
+	uint16 Component;
+	return bBaked && LookupSample(Point, OutDistance, Component);
+}
+
+bool AHynmersStaticDistanceField::ComputeNormal(const FVector& Point, FVector& OutNormal) const
+{
+	const float H = VoxelSize * 0.5f;
+	float X0, X1, Y0, Y1, Z0, Z1;
+	uint16 Component;
+	if (!LookupSample(Point - FVector(H, 0.f, 0.f), X0, Component) || !LookupSample(Point + FVector(H, 0.f, 0.f), X1, Component)
+		|| !LookupSample(Point - FVector(0.f, H, 0.f), Y0, Component) || !LookupSample(Point + FVector(0.f, H, 0.f), Y1, Component)
+		|| !LookupSample(Point - FVector(0.f, 0.f, H), Z0, Component) || !LookupSample(Point + FVector(0.f, 0.f, H), Z1, Component))
+	{
+		return false;
+	}
+
+	OutNormal = FVector(X1 - X0, Y1 - Y0, Z1 - Z0);
+	return OutNormal.Normalize();
+}
+
+EHynmersFieldResult AHynmersStaticDistanceField::SweepCapsuleDown(const FVector& Center, const FVector& UpVector, float Radius, float HalfHeight, float Distance, FHynmersFieldHit& OutHit) const
+{
+	using namespace HynmersDistanceField;
+
+	if (!bBaked)
+	{
+		return EHynmersFieldResult::Ambiguous;
+	}
+
+	float SampledDistance;
+	uint16 Component;
+
+	// The capsule moves along its axis, the upper part can only touch what it already overlaps
+	const float SegmentHalfLength = FMath::Max(HalfHeight - Radius, 0.f);
+	for (float Offset = SegmentHalfLength; Offset > -SegmentHalfLength; Offset -= VoxelSize)
+	{
+		if (!LookupSample(Center + UpVector * Offset, SampledDistance, Component) || SampledDistance < Radius - ContactTolerance)
+		{
+			return EHynmersFieldResult::Ambiguous;
+		}
+	}
+
+	// Sphere tracing of the bottom hemisphere
+	const FVector Start = Center - UpVector * SegmentHalfLength;
+	float Travelled = 0.f;
+	for (int32 Step = 0; Step < MaxSweepSteps; ++Step)
+	{
+		const FVector SphereCenter = Start - UpVector * Travelled;
+		if (!LookupSample(SphereCenter, SampledDistance, Component))
+		{
+			return EHynmersFieldResult::Ambiguous;
+		}
+
+		const float Gap = SampledDistance - Radius;
+		if (Gap <= ContactTolerance)
+		{
+			// Near edges and corners the trilinear distance rounds the shape off, the scene query finds the exact contact
+			if (Gap < -ContactTolerance || Component == NoComponent || ReleasedComponents[Component] || !IsPlanarAt(SphereCenter) || !ComputeNormal(SphereCenter, OutHit.Normal))
+			{
+				return EHynmersFieldResult::Ambiguous;
+			}
+
+			OutHit.Component = Components[Component].Get();
+			if (!OutHit.Component)
+			{
+				return EHynmersFieldResult::Ambiguous;
+			}
+
+			OutHit.Distance = Travelled;
+			OutHit.ImpactPoint = SphereCenter - OutHit.Normal * SampledDistance;
+			return EHynmersFieldResult::Hit;
+		}
+
+		Travelled += Gap;
+		if (Travelled > Distance)
+		{
+			return EHynmersFieldResult::NoHit;
+		}
+	}
+
+	// Grazing a surface, the steps got too small
+	return EHynmersFieldResult::Ambiguous;
+}
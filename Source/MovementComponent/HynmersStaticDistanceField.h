@@ -0,0 +1,193 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "HynmersStaticDistanceField.generated.h"
+
+class UActorComponent;
+class ULevel;
+class UPrimitiveComponent;
+
+enum class EHynmersFieldResult : uint8
+{
+	Hit,
+	NoHit,
+	// The field does not know this area, a scene query is needed
+	Ambiguous
+};
+
+struct FHynmersFieldHit
+{
+	// Distance travelled by the capsule
+	float Distance;
+	FVector ImpactPoint;
+	FVector Normal;
+	UPrimitiveComponent* Component;
+};
+
+/*
+ * Sparse distance field of the static collision of a world, baked on level load.
+ * Space is split in bricks of BrickSize^3 voxels and only the bricks within MaxDistance of a static
+ * collision are stored, with the distance and the closest component at every voxel corner.
+ * Distances are unsigned, points inside collision read as zero.
+ * The field is read only once baked, queries can run from any thread.
+ * Movable collision is tracked separately as hashed bounds, refreshed once per frame on the game thread,
+ * so callers can tell when the static field alone answers a query without asking the physics scene.
+ * Primitives are followed as their physics state is created and destroyed: anything registered after the bake
+ * is handled as movable, and baked components that are made movable or removed no longer answer queries.
+ */
+UCLASS()
+class MOVEMENTCOMPONENT_API AHynmersStaticDistanceField : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AHynmersStaticDistanceField();
+
+	virtual void PostInitializeComponents() override;
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	static AHynmersStaticDistanceField* Find(const UWorld* World);
+
+	// Samples the static collision of the world, replaces the previous field
+	void Bake();
+
+	bool IsBaked() const { return bBaked; }
+
+	ECollisionChannel GetCollisionChannel() const { return CollisionChannel; }
+
+	// Distance to the static collision, false where the field is ambiguous
+	bool SampleDistance(const FVector& Point, float& OutDistance) const;
+
+	// Sweeps a capsule along -UpVector. Ambiguous when the capsule starts in penetration, crosses a brick the field could not bake,
+	// or touches in a brick that is not a single plane, edges and corners where the trilinear distance is off by up to a centimeter.
+	EHynmersFieldResult SweepCapsuleDown(const FVector& Center, const FVector& UpVector, float Radius, float HalfHeight, float Distance, FHynmersFieldHit& OutHit) const;
+
+	// Hashes the bounds of the movable collision blocking the characters. Once per frame, on the game thread before the floor queries.
+	void UpdateMovables();
+
+	// Movable queries are only complete once UpdateMovables ran this frame
+	bool AreMovablesUpToDate() const { return MovablesFrame == GFrameCounter; }
+
+	// Movable collision not owned by IgnoreActor with bounds overlapping Box. Conservative, bounds only.
+	bool OverlapsMovable(const FBox& Box, const AActor* IgnoreActor) const;
+
+	UPROPERTY(Category = "Distance Field", EditAnywhere, meta = (ClampMin = "1", UIMin = "1"))
+		float VoxelSize = 20.f;
+
+	// Distance around the collision stored in the bricks, should cover a capsule radius and the floor sweep
+	UPROPERTY(Category = "Distance Field", EditAnywhere, meta = (ClampMin = "1", UIMin = "1"))
+		float MaxDistance = 160.f;
+
+	// Object type of the characters, only the geometry blocking it is baked
+	UPROPERTY(Category = "Distance Field", EditAnywhere)
+		TEnumAsByte<ECollisionChannel> CollisionChannel = ECC_Pawn;
+
+	// Bake again when a level is streamed in or out, the field is unused until then otherwise
+	UPROPERTY(Category = "Distance Field", EditAnywhere)
+		bool bRebakeOnLevelChange = true;
+
+	// Cells of the movable hash
+	UPROPERTY(Category = "Distance Field", EditAnywhere, meta = (ClampMin = "1", UIMin = "1"))
+		float MovableCellSize = 400.f;
+
+	// Seconds of motion added to the hashed bounds, for the movables moving later in the frame
+	UPROPERTY(Category = "Distance Field", EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float MovableLookahead = 0.1f;
+
+private:
+	enum
+	{
+		BrickSize = 8,
+		// Bricks store their far faces too, so a lookup never reads a neighbour
+		BrickSamples = BrickSize + 1,
+		SamplesPerBrick = BrickSamples * BrickSamples * BrickSamples
+	};
+
+	enum : int32
+	{
+		// Farther than MaxDistance from any collision
+		EmptyBrick = -1,
+		// Overlaps a collision the field can not measure, landscapes or complex only meshes
+		AmbiguousBrick = -2
+	};
+
+	static const uint16 NoComponent = MAX_uint16;
+
+	struct FBrick
+	{
+		// Distance quantized over MaxDistance
+		uint16 Distance[SamplesPerBrick];
+		// Index in Components of the closest component
+		uint16 Component[SamplesPerBrick];
+		// Every sample measures the same plane, the trilinear distance is exact
+		bool bPlanar;
+	};
+
+	// Trilinear distance and closest component at the point
+	bool LookupSample(const FVector& Point, float& OutDistance, uint16& OutComponent) const;
+
+	bool ComputeNormal(const FVector& Point, FVector& OutNormal) const;
+
+	// Brick of the point is baked and planar
+	bool IsPlanarAt(const FVector& Point) const;
+
+	// Bakes one brick from its candidate components, returns the brick state
+	int32 BakeBrick(const FIntVector& BrickCoord, const TArray<int32>& Candidates, FBrick& OutBrick) const;
+
+	void Invalidate();
+
+	void OnLevelChanged(ULevel* Level, UWorld* World);
+
+	// Also on reregistration, which is how mobility changes at runtime
+	void OnPhysicsStateCreated(UActorComponent* Component);
+
+	void OnPhysicsStateDestroyed(UActorComponent* Component);
+
+	// Tracks the movable primitives of the actor, whatever their collision at this point
+	void AddMovables(AActor* Actor);
+
+	FBox Bounds;
+
+	FIntVector NumBricks;
+
+	// Dense grid of brick indices, or EmptyBrick and AmbiguousBrick
+	TArray<int32> BrickIndices;
+
+	TArray<FBrick> Bricks;
+
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> Components;
+
+	// Bounds of Components when baked
+	TArray<FBox> ComponentBounds;
+
+	TMap<const UPrimitiveComponent*, int32> ComponentIndices;
+
+	// Baked components not at their baked place anymore, hits on them are ambiguous
+	TBitArray<> ReleasedComponents;
+
+	TSet<TWeakObjectPtr<UPrimitiveComponent>> Movables;
+
+	// Movables hashed by UpdateMovables, bounds are read again on query
+	TMap<FIntVector, TArray<UPrimitiveComponent*>> MovableCells;
+
+	// Movables covering too many cells to hash
+	TArray<UPrimitiveComponent*> LargeMovables;
+
+	uint64 MovablesFrame = MAX_uint64;
+
+	FDelegateHandle PhysicsCreatedHandle;
+
+	FDelegateHandle PhysicsDestroyedHandle;
+
+	FDelegateHandle LevelAddedHandle;
+
+	FDelegateHandle LevelRemovedHandle;
+
+	bool bBaked = false;
+};
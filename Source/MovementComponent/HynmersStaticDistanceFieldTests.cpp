@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersMovementTestWorld.h"
+#include "HynmersStaticDistanceField.h"
+
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMeshActor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HynmersDistanceFieldTest
+{
+	static const float SweepDistance = 50.f;
+
+	// Capsule of a character standing SweepDistance / 5 above Height at Location
+	static EHynmersFieldResult SweepAbove(const AHynmersStaticDistanceField* Field, const FVector& Location, float Height, FHynmersFieldHit& OutHit)
+	{
+		const float Radius = FHynmersMovementTestWorld::CapsuleRadius;
+		const float HalfHeight = FHynmersMovementTestWorld::CapsuleHalfHeight;
+		const FVector Center(Location.X, Location.Y, Height + HalfHeight + SweepDistance * 0.2f);
+		return Field->SweepCapsuleDown(Center, FVector::UpVector, Radius, HalfHeight, SweepDistance, OutHit);
+	}
+
+	static FBox BoxAbove(const FVector& Location, float Height)
+	{
+		return FBox::BuildAABB(FVector(Location.X, Location.Y, Height + 10.f), FVector(20.f));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHynmersDistanceFieldRuntimeMovableTest, "Hynmers.Movement.DistanceField.RuntimeMovable",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FHynmersDistanceFieldRuntimeMovableTest::RunTest(const FString& Parameters)
+{
+	using namespace HynmersDistanceFieldTest;
+
+	FHynmersMovementTestWorld TestWorld;
+	if (!TestWorld.Initialize())
+	{
+		AddError(TEXT("Could not create the test world"));
+		return false;
+	}
+
+	const FVector PlatformLocation(0.f, 0.f, 0.f);
+	const FVector LateLocation(-1000.f, 0.f, 0.f);
+	const float PlatformTop = 100.f;
+
+	TestWorld.AddBox(FVector(0.f, 0.f, -50.f), FVector(2000.f, 2000.f, 50.f));
+	AStaticMeshActor* Platform = TestWorld.AddBox(PlatformLocation + FVector(0.f, 0.f, 50.f), FVector(200.f, 200.f, 50.f));
+	AHynmersStaticDistanceField* Field = TestWorld.AddStaticDistanceField();
+	if (!TestTrue(TEXT("Field baked"), Field && Field->IsBaked()))
+	{
+		return false;
+	}
+
+	// Static after the bake, the field knows nothing about it
+	AStaticMeshActor* Late = TestWorld.AddBox(LateLocation + FVector(0.f, 0.f, 50.f), FVector(100.f, 100.f, 50.f));
+
+	TestWorld.Tick(1.f / 60.f);
+	Field->UpdateMovables();
+
+	FHynmersFieldHit Hit;
+	TestEqual(TEXT("Baked platform answered by the field"), (int32)SweepAbove(Field, PlatformLocation, PlatformTop, Hit), (int32)EHynmersFieldResult::Hit);
+	TestTrue(TEXT("Hit on the baked platform"), Hit.Component == Platform->GetStaticMeshComponent());
+	TestTrue(TEXT("Box spawned after the bake tracked"), Field->OverlapsMovable(BoxAbove(LateLocation, PlatformTop), nullptr));
+
+	// Made movable at runtime and moved away, the field must not report its old top as a floor
+	const FVector MovedLocation(1000.f, 0.f, 0.f);
+	Platform->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+	Platform->SetActorLocation(MovedLocation + FVector(0.f, 0.f, 50.f));
+	const FVector LateMovedLocation(-1000.f, 600.f, 0.f);
+	Late->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+	Late->SetActorLocation(LateMovedLocation + FVector(0.f, 0.f, 50.f));
+
+	TestWorld.Tick(1.f / 60.f);
+	Field->UpdateMovables();
+
+	TestNotEqual(TEXT("Released platform not a field floor"), (int32)SweepAbove(Field, PlatformLocation, PlatformTop, Hit), (int32)EHynmersFieldResult::Hit);
+	TestTrue(TEXT("Moved platform tracked as movable"), Field->OverlapsMovable(BoxAbove(MovedLocation, PlatformTop), nullptr));
+	TestTrue(TEXT("Moved late box tracked at its new place"), Field->OverlapsMovable(BoxAbove(LateMovedLocation, PlatformTop), nullptr));
+	TestFalse(TEXT("Moved late box left its old place"), Field->OverlapsMovable(BoxAbove(LateLocation, PlatformTop), nullptr));
+
+	// Removed, nothing left to overlap
+	Late->Destroy();
+	TestWorld.Tick(1.f / 60.f);
+	Field->UpdateMovables();
+	TestFalse(TEXT("Destroyed box untracked"), Field->OverlapsMovable(BoxAbove(LateMovedLocation, PlatformTop), nullptr));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,484 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersSurfaceNavGraph.h"
+
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHynmersSurfaceNav, Log, All);
+
+namespace HynmersSurfaceNav
+{
+	static TMap<TWeakObjectPtr<const UWorld>, TWeakObjectPtr<AHynmersSurfaceNavGraph>> WorldGraphs;
+
+	// Space between the surface and the bottom of the agent capsule
+	static const float ClearanceOffset = 5.f;
+
+	// Linked nodes with normals closer than 20 degrees are on the same surface
+	static const float FlatEdgeCos = 0.94f;
+
+	// Surfaces found along one sample trace, stacked floors included
+	static const int32 MaxSurfacesPerTrace = 64;
+
+	typedef FHynmersNavSearchScratch::FOpenEntry FOpenEntry;
+
+	// A* over vertices 0..NumVertices-1. ForEachNeighbour(Index, Visit) calls Visit(Neighbour, EdgeCost) for every usable edge.
+	template<typename NeighbourFunc, typename HeuristicFunc>
+	static bool AStar(FHynmersNavSearchScratch& Scratch, int32 NumVertices, int32 Start, int32 Goal, NeighbourFunc ForEachNeighbour, HeuristicFunc Heuristic, TArray<int32>& OutPath)
+	{
+		TArray<float>& Costs = Scratch.Costs;
+		TArray<int32>& Parents = Scratch.Parents;
+		TArray<uint32>& Visited = Scratch.VisitedGenerations;
+		TArray<uint32>& Closed = Scratch.ClosedGenerations;
+		TArray<FOpenEntry>& Open = Scratch.Open;
+
+		// Sized again only when the graph was baked since the last search
+		if (Visited.Num() != NumVertices)
+		{
+			Costs.SetNumUninitialized(NumVertices);
+			Parents.SetNumUninitialized(NumVertices);
+			Visited.Init(0, NumVertices);
+			Closed.Init(0, NumVertices);
+			Scratch.Generation = 0;
+		}
+
+		// Wrapped around, stale stamps could match again
+		if (++Scratch.Generation == 0)
+		{
+			FMemory::Memzero(Visited.GetData(), Visited.Num() * sizeof(uint32));
+			FMemory::Memzero(Closed.GetData(), Closed.Num() * sizeof(uint32));
+			Scratch.Generation = 1;
+		}
+		const uint32 Generation = Scratch.Generation;
+		Open.Reset();
+
+		Costs[Start] = 0.f;
+		Parents[Start] = INDEX_NONE;
+		Visited[Start] = Generation;
+		Open.HeapPush(FOpenEntry{ Start, Heuristic(Start) });
+		while (Open.Num() > 0)
+		{
+			FOpenEntry Current;
+			Open.HeapPop(Current, false);
+			if (Closed[Current.Index] == Generation)
+			{
+				continue;
+			}
+
+			if (Current.Index == Goal)
+			{
+				OutPath.Reset();
+				for (int32 Index = Goal; Index != INDEX_NONE; Index = Parents[Index])
+				{
+					OutPath.Add(Index);
+				}
+				for (int32 i = 0, j = OutPath.Num() - 1; i < j; ++i, --j)
+				{
+					OutPath.Swap(i, j);
+				}
+				return true;
+			}
+
+			Closed[Current.Index] = Generation;
+			const float CurrentCost = Costs[Current.Index];
+			ForEachNeighbour(Current.Index, [&](int32 Neighbour, float EdgeCost)
+			{
+				const float Cost = CurrentCost + EdgeCost;
+				if (Closed[Neighbour] != Generation && (Visited[Neighbour] != Generation || Cost < Costs[Neighbour]))
+				{
+					Visited[Neighbour] = Generation;
+					Costs[Neighbour] = Cost;
+					Parents[Neighbour] = Current.Index;
+					Open.HeapPush(FOpenEntry{ Neighbour, Cost + Heuristic(Neighbour) });
+				}
+			});
+		}
+
+		return false;
+	}
+}
+
+AHynmersSurfaceNavGraph::AHynmersSurfaceNavGraph()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = false;
+
+	BakeBounds = CreateDefaultSubobject<UBoxComponent>(TEXT("BakeBounds"));
+	BakeBounds->SetBoxExtent(FVector(2000.f));
+	BakeBounds->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	BakeBounds->bGenerateOverlapEvents = false;
+	RootComponent = BakeBounds;
+}
+
+void AHynmersSurfaceNavGraph::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildNodeHash();
+}
+
+void AHynmersSurfaceNavGraph::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	if (GetWorld() && GetWorld()->IsGameWorld())
+	{
+		HynmersSurfaceNav::WorldGraphs.Add(GetWorld(), this);
+	}
+}
+
+void AHynmersSurfaceNavGraph::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	const TWeakObjectPtr<AHynmersSurfaceNavGraph>* Registered = HynmersSurfaceNav::WorldGraphs.Find(GetWorld());
+	if (Registered && Registered->Get() == this)
+	{
+		HynmersSurfaceNav::WorldGraphs.Remove(GetWorld());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+AHynmersSurfaceNavGraph* AHynmersSurfaceNavGraph::Find(const UWorld* World)
+{
+	const TWeakObjectPtr<AHynmersSurfaceNavGraph>* Registered = World ? HynmersSurfaceNav::WorldGraphs.Find(World) : nullptr;
+	return Registered ? Registered->Get() : nullptr;
+}
+
+void AHynmersSurfaceNavGraph::Bake()
+{
+	Nodes.Reset();
+	Edges.Reset();
+	Clusters.Reset();
+	ClusterEdges.Reset();
+	NodeHash.Reset();
+
+	if (!GetWorld())
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	const FBox Box = BakeBounds->Bounds.GetBox();
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		AddSurfaceSamples(Box, Axis, 1.f);
+		AddSurfaceSamples(Box, Axis, -1.f);
+	}
+
+	BuildNodeHash();
+	BuildEdges();
+	BuildClusters();
+
+	MarkPackageDirty();
+
+	UE_LOG(LogHynmersSurfaceNav, Display, TEXT("%s: baked %d nodes, %d edges and %d clusters in %.2f s"),
+		*GetName(), Nodes.Num(), Edges.Num(), Clusters.Num(), FPlatformTime::Seconds() - StartTime);
+}
+
+void AHynmersSurfaceNavGraph::AddSurfaceSamples(const FBox& Box, int32 Axis, float Sign)
+{
+	using namespace HynmersSurfaceNav;
+
+	const int32 U = (Axis + 1) % 3;
+	const int32 V = (Axis + 2) % 3;
+	FVector Direction = FVector::ZeroVector;
+	Direction[Axis] = Sign;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HynmersNavBake), false, this);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+
+	for (float A = Box.Min[U] + CellSize * 0.5f; A < Box.Max[U]; A += CellSize)
+	{
+		for (float B = Box.Min[V] + CellSize * 0.5f; B < Box.Max[V]; B += CellSize)
+		{
+			FVector Start;
+			Start[Axis] = Sign > 0.f ? Box.Min[Axis] : Box.Max[Axis];
+			Start[U] = A;
+			Start[V] = B;
+			const FVector End = Start + Direction * (Box.Max[Axis] - Box.Min[Axis]);
+
+			// Every surface facing the trace, stepping through the solids
+			for (int32 Surface = 0; Surface < MaxSurfacesPerTrace && ((End - Start) | Direction) > 0.f; ++Surface)
+			{
+				FHitResult Hit;
+				if (!GetWorld()->LineTraceSingleByChannel(Hit, Start, End, CollisionChannel, QueryParams))
+				{
+					break;
+				}
+
+				// Each surface is sampled along the axis closest to its normal only
+				const FVector Normal = Hit.ImpactNormal;
+				const float Facing = -Normal[Axis] * Sign;
+				if (!Hit.bStartPenetrating && Facing >= FMath::Abs(Normal[U]) && Facing >= FMath::Abs(Normal[V]) && FitsAgent(Hit.ImpactPoint, Normal))
+				{
+					FHynmersNavNode& Node = Nodes[Nodes.AddDefaulted()];
+					Node.Location = Hit.ImpactPoint;
+					Node.Normal = Normal;
+				}
+
+				Start = Hit.ImpactPoint + Direction * CellSize;
+			}
+		}
+	}
+}
+
+bool AHynmersSurfaceNavGraph::FitsAgent(const FVector& Location, const FVector& Normal) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HynmersNavBake), false, this);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+
+	const FVector Center = Location + Normal * (AgentHalfHeight + HynmersSurfaceNav::ClearanceOffset);
+	const FQuat Rotation = FRotationMatrix::MakeFromZ(Normal).ToQuat();
+	return !GetWorld()->OverlapBlockingTestByChannel(Center, Rotation, CollisionChannel, FCollisionShape::MakeCapsule(AgentRadius, AgentHalfHeight), QueryParams);
+}
+
+FIntVector AHynmersSurfaceNavGraph::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void AHynmersSurfaceNavGraph::BuildNodeHash()
+{
+	NodeHash.Reset();
+	for (int32 Index = 0; Index < Nodes.Num(); ++Index)
+	{
+		NodeHash.FindOrAdd(GetCell(Nodes[Index].Location)).Add(Index);
+	}
+}
+
+void AHynmersSurfaceNavGraph::BuildEdges()
+{
+	using namespace HynmersSurfaceNav;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HynmersNavBake), false, this);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+
+	// Nodes on both sides of a corner are up to a cell from it
+	const float MaxEdgeLength = CellSize * 1.5f;
+	const float MinNormalDot = FMath::Cos(FMath::DegreesToRadians(MaxEdgeAngle));
+	// High enough for the probe to pass outside outer corners
+	const float ProbeHeight = CellSize;
+
+	for (int32 Index = 0; Index < Nodes.Num(); ++Index)
+	{
+		FHynmersNavNode& Node = Nodes[Index];
+		Node.FirstEdge = Edges.Num();
+
+		const FIntVector Cell = GetCell(Node.Location);
+		for (int32 Z = -2; Z <= 2; ++Z)
+		{
+			for (int32 Y = -2; Y <= 2; ++Y)
+			{
+				for (int32 X = -2; X <= 2; ++X)
+				{
+					const TArray<int32>* CellNodes = NodeHash.Find(Cell + FIntVector(X, Y, Z));
+					if (!CellNodes)
+					{
+						continue;
+					}
+
+					for (int32 Other : *CellNodes)
+					{
+						const FHynmersNavNode& OtherNode = Nodes[Other];
+						const FVector Delta = OtherNode.Location - Node.Location;
+						const float NormalDot = Node.Normal | OtherNode.Normal;
+						if (Other == Index || Delta.SizeSquared() > FMath::Square(MaxEdgeLength) || NormalDot < MinNormalDot)
+						{
+							continue;
+						}
+
+						if (GetWorld()->LineTraceTestByChannel(Node.Location + Node.Normal * ProbeHeight, OtherNode.Location + OtherNode.Normal * ProbeHeight, CollisionChannel, QueryParams))
+						{
+							continue;
+						}
+
+						FHynmersNavEdge& Edge = Edges[Edges.AddDefaulted()];
+						Edge.Target = Other;
+						Edge.Cost = Delta.Size();
+						if (NormalDot < FlatEdgeCos)
+						{
+							Edge.Type = (Delta | Node.Normal) < 0.f ? EHynmersNavEdgeType::Convex : EHynmersNavEdgeType::Concave;
+						}
+					}
+				}
+			}
+		}
+
+		Node.NumEdges = Edges.Num() - Node.FirstEdge;
+	}
+}
+
+void AHynmersSurfaceNavGraph::BuildClusters()
+{
+	const float ClusterWorldSize = CellSize * ClusterSize;
+
+	TMap<FIntVector, int32> ClusterCells;
+	TArray<int32> ClusterCounts;
+	for (FHynmersNavNode& Node : Nodes)
+	{
+		const FIntVector Cell(FMath::FloorToInt(Node.Location.X / ClusterWorldSize), FMath::FloorToInt(Node.Location.Y / ClusterWorldSize), FMath::FloorToInt(Node.Location.Z / ClusterWorldSize));
+		int32* Found = ClusterCells.Find(Cell);
+		const int32 Cluster = Found ? *Found : ClusterCells.Add(Cell, Clusters.AddDefaulted());
+		ClusterCounts.SetNumZeroed(Clusters.Num());
+
+		Node.Cluster = Cluster;
+		Clusters[Cluster].Center += Node.Location;
+		++ClusterCounts[Cluster];
+	}
+
+	TArray<TSet<int32>> Neighbours;
+	Neighbours.SetNum(Clusters.Num());
+	for (const FHynmersNavNode& Node : Nodes)
+	{
+		for (int32 EdgeIndex = Node.FirstEdge; EdgeIndex < Node.FirstEdge + Node.NumEdges; ++EdgeIndex)
+		{
+			const int32 OtherCluster = Nodes[Edges[EdgeIndex].Target].Cluster;
+			if (OtherCluster != Node.Cluster)
+			{
+				Neighbours[Node.Cluster].Add(OtherCluster);
+			}
+		}
+	}
+
+	for (int32 Cluster = 0; Cluster < Clusters.Num(); ++Cluster)
+	{
+		Clusters[Cluster].Center /= ClusterCounts[Cluster];
+	}
+
+	for (int32 Cluster = 0; Cluster < Clusters.Num(); ++Cluster)
+	{
+		Clusters[Cluster].FirstEdge = ClusterEdges.Num();
+		for (int32 Other : Neighbours[Cluster])
+		{
+			FHynmersNavEdge& Edge = ClusterEdges[ClusterEdges.AddDefaulted()];
+			Edge.Target = Other;
+			Edge.Cost = FVector::Dist(Clusters[Cluster].Center, Clusters[Other].Center);
+		}
+		Clusters[Cluster].NumEdges = ClusterEdges.Num() - Clusters[Cluster].FirstEdge;
+	}
+}
+
+int32 AHynmersSurfaceNavGraph::FindNearestNode(const FVector& Location, float MaxDistance) const
+{
+	const int32 CellRadius = FMath::CeilToInt(MaxDistance / CellSize);
+	const FIntVector Cell = GetCell(Location);
+
+	int32 BestNode = INDEX_NONE;
+	float BestDistSq = FMath::Square(MaxDistance);
+	for (int32 Z = -CellRadius; Z <= CellRadius; ++Z)
+	{
+		for (int32 Y = -CellRadius; Y <= CellRadius; ++Y)
+		{
+			for (int32 X = -CellRadius; X <= CellRadius; ++X)
+			{
+				if (const TArray<int32>* CellNodes = NodeHash.Find(Cell + FIntVector(X, Y, Z)))
+				{
+					for (int32 Index : *CellNodes)
+					{
+						const float DistSq = FVector::DistSquared(Nodes[Index].Location, Location);
+						if (DistSq < BestDistSq)
+						{
+							BestDistSq = DistSq;
+							BestNode = Index;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return BestNode;
+}
+
+bool AHynmersSurfaceNavGraph::SearchClusters(int32 StartCluster, int32 GoalCluster, TArray<int32>& OutClusters) const
+{
+	const FVector GoalCenter = Clusters[GoalCluster].Center;
+	return HynmersSurfaceNav::AStar(ClusterSearch, Clusters.Num(), StartCluster, GoalCluster,
+		[this](int32 Cluster, auto&& Visit)
+		{
+			const FHynmersNavCluster& Current = Clusters[Cluster];
+			for (int32 EdgeIndex = Current.FirstEdge; EdgeIndex < Current.FirstEdge + Current.NumEdges; ++EdgeIndex)
+			{
+				Visit(ClusterEdges[EdgeIndex].Target, ClusterEdges[EdgeIndex].Cost);
+			}
+		},
+		[this, &GoalCenter](int32 Cluster) { return FVector::Dist(Clusters[Cluster].Center, GoalCenter); },
+		OutClusters);
+}
+
+bool AHynmersSurfaceNavGraph::SearchNodes(int32 StartNode, int32 GoalNode, const TBitArray<>* AllowedClusters, TArray<int32>& OutNodes) const
+{
+	const FVector GoalLocation = Nodes[GoalNode].Location;
+	return HynmersSurfaceNav::AStar(NodeSearch, Nodes.Num(), StartNode, GoalNode,
+		[this, AllowedClusters](int32 Index, auto&& Visit)
+		{
+			const FHynmersNavNode& Current = Nodes[Index];
+			for (int32 EdgeIndex = Current.FirstEdge; EdgeIndex < Current.FirstEdge + Current.NumEdges; ++EdgeIndex)
+			{
+				const FHynmersNavEdge& Edge = Edges[EdgeIndex];
+				if (!AllowedClusters || (*AllowedClusters)[Nodes[Edge.Target].Cluster])
+				{
+					Visit(Edge.Target, Edge.Cost);
+				}
+			}
+		},
+		[this, &GoalLocation](int32 Index) { return FVector::Dist(Nodes[Index].Location, GoalLocation); },
+		OutNodes);
+}
+
+bool AHynmersSurfaceNavGraph::FindPath(const FVector& Start, const FVector& Goal, TArray<FHynmersPathPoint>& OutPath) const
+{
+	// The search scratch arrays are shared by every query
+	check(IsInGameThread());
+
+	OutPath.Reset();
+
+	const int32 StartNode = FindNearestNode(Start, MaxQueryDistance);
+	const int32 GoalNode = FindNearestNode(Goal, MaxQueryDistance);
+	if (StartNode == INDEX_NONE || GoalNode == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Clusters not connected, the nodes can not be either
+	TArray<int32> ClusterPath;
+	if (!SearchClusters(Nodes[StartNode].Cluster, Nodes[GoalNode].Cluster, ClusterPath))
+	{
+		return false;
+	}
+
+	// Corridor of the clusters on the way and their neighbours
+	TBitArray<> AllowedClusters(false, Clusters.Num());
+	for (int32 Cluster : ClusterPath)
+	{
+		AllowedClusters[Cluster] = true;
+		for (int32 EdgeIndex = Clusters[Cluster].FirstEdge; EdgeIndex < Clusters[Cluster].FirstEdge + Clusters[Cluster].NumEdges; ++EdgeIndex)
+		{
+			AllowedClusters[ClusterEdges[EdgeIndex].Target] = true;
+		}
+	}
+
+	// Nodes of a cluster are not always connected inside it, the corridor can miss the way around
+	TArray<int32> NodePath;
+	if (!SearchNodes(StartNode, GoalNode, &AllowedClusters, NodePath) && !SearchNodes(StartNode, GoalNode, nullptr, NodePath))
+	{
+		return false;
+	}
+
+	OutPath.Reserve(NodePath.Num() + 1);
+	for (int32 Index : NodePath)
+	{
+		FHynmersPathPoint& Point = OutPath[OutPath.AddDefaulted()];
+		Point.Location = Nodes[Index].Location;
+		Point.Normal = Nodes[Index].Normal;
+	}
+
+	// End on the goal, brought down on the surface of the last node
+	const FHynmersNavNode& Last = Nodes[GoalNode];
+	FHynmersPathPoint& End = OutPath[OutPath.AddDefaulted()];
+	End.Location = FVector::PointPlaneProject(Goal, Last.Location, Last.Normal);
+	End.Normal = Last.Normal;
+	return true;
+}
@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "HynmersSurfaceNavGraph.generated.h"
+
+class UBoxComponent;
+
+UENUM()
+enum class EHynmersNavEdgeType : uint8
+{
+	Flat,
+	// Over an outer corner, the surface bends away from the character
+	Convex,
+	// Into an inner corner, the surface bends toward the character
+	Concave
+};
+
+USTRUCT()
+struct FHynmersNavNode
+{
+	GENERATED_BODY()
+
+	// Point on the surface
+	UPROPERTY()
+		FVector Location = FVector::ZeroVector;
+
+	UPROPERTY()
+		FVector Normal = FVector::UpVector;
+
+	// Range in Edges
+	UPROPERTY()
+		int32 FirstEdge = 0;
+
+	UPROPERTY()
+		int32 NumEdges = 0;
+
+	UPROPERTY()
+		int32 Cluster = INDEX_NONE;
+};
+
+USTRUCT()
+struct FHynmersNavEdge
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		int32 Target = INDEX_NONE;
+
+	UPROPERTY()
+		float Cost = 0.f;
+
+	UPROPERTY()
+		EHynmersNavEdgeType Type = EHynmersNavEdgeType::Flat;
+};
+
+// Group of nodes in a coarse cell, the level searched first
+USTRUCT()
+struct FHynmersNavCluster
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		FVector Center = FVector::ZeroVector;
+
+	// Range in ClusterEdges
+	UPROPERTY()
+		int32 FirstEdge = 0;
+
+	UPROPERTY()
+		int32 NumEdges = 0;
+};
+
+USTRUCT(BlueprintType)
+struct FHynmersPathPoint
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Category = "Navigation", BlueprintReadOnly)
+		FVector Location = FVector::ZeroVector;
+
+	// Up vector of the character at this point
+	UPROPERTY(Category = "Navigation", BlueprintReadOnly)
+		FVector Normal = FVector::UpVector;
+};
+
+/*
+ * A* state of one level of the graph, kept between searches so a query does not allocate and clear arrays over the whole graph.
+ * Costs and parents of a vertex are valid only when it is stamped with the current generation.
+ */
+struct FHynmersNavSearchScratch
+{
+	struct FOpenEntry
+	{
+		int32 Index;
+		float Cost;
+
+		bool operator<(const FOpenEntry& Other) const { return Cost < Other.Cost; }
+	};
+
+	TArray<float> Costs;
+	TArray<int32> Parents;
+	TArray<uint32> VisitedGenerations;
+	TArray<uint32> ClosedGenerations;
+	TArray<FOpenEntry> Open;
+	uint32 Generation = 0;
+};
+
+/*
+ * Navigation graph over the walkable collision inside its box, in any orientation.
+ * Baked in the editor and saved with the level: surfaces are sampled by line traces along the six axes,
+ * nodes keep the ones a capsule standing along the normal fits on, and close nodes are linked when the
+ * agent can move between them, including across outer and inner corners.
+ * Paths are searched with A* over the clusters first, then over the nodes of the clusters found.
+ */
+UCLASS()
+class MOVEMENTCOMPONENT_API AHynmersSurfaceNavGraph : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AHynmersSurfaceNavGraph();
+
+	virtual void PostLoad() override;
+
+	virtual void PostInitializeComponents() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	static AHynmersSurfaceNavGraph* Find(const UWorld* World);
+
+	// Samples the collision inside the box, replaces the graph
+	UFUNCTION(Category = "Navigation", CallInEditor)
+		void Bake();
+
+	// Closest node within MaxDistance, INDEX_NONE if there is none
+	int32 FindNearestNode(const FVector& Location, float MaxDistance) const;
+
+	// Path from the node closest to Start to Goal. False if either end is off the graph or they are not connected.
+	// Game thread only.
+	bool FindPath(const FVector& Start, const FVector& Goal, TArray<FHynmersPathPoint>& OutPath) const;
+
+	int32 GetNumNodes() const { return Nodes.Num(); }
+
+	const FHynmersNavNode& GetNode(int32 Index) const { return Nodes[Index]; }
+
+	// Spacing of the surface samples
+	UPROPERTY(Category = "Navigation", EditAnywhere, meta = (ClampMin = "5", UIMin = "5"))
+		float CellSize = 50.f;
+
+	// Clusters are ClusterSize cells wide
+	UPROPERTY(Category = "Navigation", EditAnywhere, meta = (ClampMin = "2", UIMin = "2"))
+		int32 ClusterSize = 8;
+
+	UPROPERTY(Category = "Navigation", EditAnywhere)
+		float AgentRadius = 42.f;
+
+	UPROPERTY(Category = "Navigation", EditAnywhere)
+		float AgentHalfHeight = 96.f;
+
+	// Largest angle between the normals of linked nodes
+	UPROPERTY(Category = "Navigation", EditAnywhere, meta = (ClampMin = "0", ClampMax = "180", UIMin = "0", UIMax = "180"))
+		float MaxEdgeAngle = 100.f;
+
+	// How far a query location can be from the graph
+	UPROPERTY(Category = "Navigation", EditAnywhere)
+		float MaxQueryDistance = 200.f;
+
+	UPROPERTY(Category = "Navigation", EditAnywhere)
+		TEnumAsByte<ECollisionChannel> CollisionChannel = ECC_Pawn;
+
+private:
+	void AddSurfaceSamples(const FBox& Box, int32 Axis, float Sign);
+
+	bool FitsAgent(const FVector& Location, const FVector& Normal) const;
+
+	void BuildEdges();
+
+	void BuildClusters();
+
+	void BuildNodeHash();
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	bool SearchClusters(int32 StartCluster, int32 GoalCluster, TArray<int32>& OutClusters) const;
+
+	// Node path, restricted to the allowed clusters when given
+	bool SearchNodes(int32 StartNode, int32 GoalNode, const TBitArray<>* AllowedClusters, TArray<int32>& OutNodes) const;
+
+	// Volume sampled by the bake
+	UPROPERTY(Category = "Navigation", VisibleAnywhere)
+		UBoxComponent* BakeBounds;
+
+	UPROPERTY()
+		TArray<FHynmersNavNode> Nodes;
+
+	UPROPERTY()
+		TArray<FHynmersNavEdge> Edges;
+
+	UPROPERTY()
+		TArray<FHynmersNavCluster> Clusters;
+
+	// Edges between clusters, Target is a cluster index
+	UPROPERTY()
+		TArray<FHynmersNavEdge> ClusterEdges;
+
+	// Nodes per cell, rebuilt on load
+	TMap<FIntVector, TArray<int32>> NodeHash;
+
+	// Paths are searched on the game thread only
+	mutable FHynmersNavSearchScratch ClusterSearch;
+
+	mutable FHynmersNavSearchScratch NodeSearch;
+};
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersSurfacePathFollowingComponent.h"
+#include "HynmersMovementComponent.h"
+#include "HynmersTangentMath.h"
+
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/Controller.h"
+
+UHynmersSurfacePathFollowingComponent::UHynmersSurfacePathFollowingComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+void UHynmersSurfacePathFollowingComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// The controller already ticks before the movement of its pawn, or the movement manager
+	if (AController* Controller = Cast<AController>(GetOwner()))
+	{
+		Controller->PrimaryActorTick.AddPrerequisite(this, PrimaryComponentTick);
+	}
+	else if (UHynmersMovementComponent* MovementComponent = GetMovementComponent())
+	{
+		MovementComponent->AddTickPrerequisiteComponent(this);
+	}
+}
+
+UHynmersMovementComponent* UHynmersSurfacePathFollowingComponent::GetMovementComponent() const
+{
+	const AController* Controller = Cast<AController>(GetOwner());
+	const ACharacter* Character = Cast<ACharacter>(Controller ? Controller->GetPawn() : GetOwner());
+	return Character ? Cast<UHynmersMovementComponent>(Character->GetCharacterMovement()) : nullptr;
+}
+
+bool UHynmersSurfacePathFollowingComponent::MoveToLocation(const FVector& Goal)
+{
+	StopMovement();
+
+	const UHynmersMovementComponent* MovementComponent = GetMovementComponent();
+	const AHynmersSurfaceNavGraph* Graph = AHynmersSurfaceNavGraph::Find(GetWorld());
+	if (!MovementComponent || !MovementComponent->UpdatedComponent || !Graph)
+	{
+		return false;
+	}
+
+	const float HalfHeight = MovementComponent->GetCharacterOwner()->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	const FVector Feet = MovementComponent->UpdatedComponent->GetComponentLocation() - MovementComponent->UpdatedComponent->GetUpVector() * HalfHeight;
+	if (!Graph->FindPath(Feet, Goal, Path))
+	{
+		return false;
+	}
+
+	PathIndex = 0;
+	return true;
+}
+
+void UHynmersSurfacePathFollowingComponent::StopMovement()
+{
+	Path.Reset();
+	PathIndex = INDEX_NONE;
+}
+
+void UHynmersSurfacePathFollowingComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (PathIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	UHynmersMovementComponent* MovementComponent = GetMovementComponent();
+	if (!MovementComponent || !MovementComponent->UpdatedComponent)
+	{
+		StopMovement();
+		return;
+	}
+
+	const FVector UpVector = MovementComponent->UpdatedComponent->GetUpVector();
+	const float HalfHeight = MovementComponent->GetCharacterOwner()->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	const FVector Feet = MovementComponent->UpdatedComponent->GetComponentLocation() - UpVector * HalfHeight;
+
+	// Skip the points reached, distances are measured on the surface the character stands on
+	FVector ToPoint;
+	for (;;)
+	{
+		ToPoint = HynmersTangentMath::ProjectOnPlane(Path[PathIndex].Location - Feet, UpVector);
+		const bool bLastPoint = PathIndex == Path.Num() - 1;
+		const float Radius = bLastPoint ? GoalAcceptanceRadius : AcceptanceRadius;
+		if (ToPoint.SizeSquared() > FMath::Square(Radius))
+		{
+			break;
+		}
+
+		if (bLastPoint)
+		{
+			StopMovement();
+			return;
+		}
+		++PathIndex;
+	}
+
+	MovementComponent->RequestDirectMove(ToPoint.GetSafeNormal() * MovementComponent->GetMaxSpeed(), bForceMaxSpeed);
+}
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "HynmersSurfaceNavGraph.h"
+#include "HynmersSurfacePathFollowingComponent.generated.h"
+
+class UHynmersMovementComponent;
+
+/*
+ * Follows paths of the world AHynmersSurfaceNavGraph by requesting velocities on the tangent plane of the character.
+ * Added to the AI controller, which ticks before the movement of its pawn, or to a pawn ticking its own movement.
+ */
+UCLASS(ClassGroup = (Movement), meta = (BlueprintSpawnableComponent))
+class MOVEMENTCOMPONENT_API UHynmersSurfacePathFollowingComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UHynmersSurfacePathFollowingComponent();
+
+	virtual void BeginPlay() override;
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+
+	// Searches a path to Goal and starts following it, false if there is none
+	UFUNCTION(BlueprintCallable, Category = "Navigation")
+		bool MoveToLocation(const FVector& Goal);
+
+	UFUNCTION(BlueprintCallable, Category = "Navigation")
+		void StopMovement();
+
+	UFUNCTION(BlueprintPure, Category = "Navigation")
+		bool IsFollowingPath() const { return PathIndex != INDEX_NONE; }
+
+	const TArray<FHynmersPathPoint>& GetPath() const { return Path; }
+
+	// Distance along the surface at which a path point is reached
+	UPROPERTY(Category = "Navigation", EditAnywhere, BlueprintReadWrite)
+		float AcceptanceRadius = 40.f;
+
+	UPROPERTY(Category = "Navigation", EditAnywhere, BlueprintReadWrite)
+		float GoalAcceptanceRadius = 20.f;
+
+	// Follow the path at the max speed of the movement component instead of accelerating to it
+	UPROPERTY(Category = "Navigation", EditAnywhere, BlueprintReadWrite)
+		bool bForceMaxSpeed = false;
+
+private:
+	UHynmersMovementComponent* GetMovementComponent() const;
+
+	TArray<FHynmersPathPoint> Path;
+
+	int32 PathIndex = INDEX_NONE;
+};
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersTraceDecodeCommandlet.h"
+#include "HynmersMovementTrace.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHynmersTraceDecode, Log, All);
+
+UHynmersTraceDecodeCommandlet::UHynmersTraceDecodeCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UHynmersTraceDecodeCommandlet::Main(const FString& Params)
+{
+	FString Filename;
+	if (!FParse::Value(*Params, TEXT("File="), Filename))
+	{
+		UE_LOG(LogHynmersTraceDecode, Error, TEXT("Usage: -run=HynmersTraceDecode -File=<dump.hmtrace> [-Csv=<output.csv>]"));
+		return 1;
+	}
+
+	TArray<FHynmersTraceDump> Dumps;
+	double SecondsPerCycle = 0.0;
+	if (!FHynmersMovementTrace::LoadFromFile(Filename, Dumps, SecondsPerCycle))
+	{
+		UE_LOG(LogHynmersTraceDecode, Error, TEXT("Could not read movement trace %s"), *Filename);
+		return 1;
+	}
+
+	FString Csv = TEXT("Character,Frame,Milliseconds,Event,MovementMode,Param,Value,X,Y,Z\n");
+	for (const FHynmersTraceDump& Dump : Dumps)
+	{
+		// Times are relative to the first record of each character
+		const uint32 FirstCycles = Dump.Records.Num() > 0 ? Dump.Records[0].Cycles : 0;
+		for (const FHynmersTraceRecord& Record : Dump.Records)
+		{
+			const double Milliseconds = (double)(uint32)(Record.Cycles - FirstCycles) * SecondsPerCycle * 1000.0;
+			Csv += FString::Printf(TEXT("%s,%u,%.3f,%s,%u,%u,%.3f,%.2f,%.2f,%.2f\n"), *Dump.Name, Record.Frame, Milliseconds,
+				FHynmersMovementTrace::GetEventName(Record.Event), Record.MovementMode, Record.Param, Record.Value,
+				Record.Vector.X, Record.Vector.Y, Record.Vector.Z);
+		}
+	}
+
+	FString CsvFilename;
+	if (FParse::Value(*Params, TEXT("Csv="), CsvFilename))
+	{
+		if (!FFileHelper::SaveStringToFile(Csv, *CsvFilename))
+		{
+			UE_LOG(LogHynmersTraceDecode, Error, TEXT("Could not write %s"), *CsvFilename);
+			return 1;
+		}
+		UE_LOG(LogHynmersTraceDecode, Display, TEXT("Decoded %d characters to %s"), Dumps.Num(), *CsvFilename);
+	}
+	else
+	{
+		UE_LOG(LogHynmersTraceDecode, Display, TEXT("%s"), *Csv);
+	}
+
+	return 0;
+}
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HynmersTraceDecodeCommandlet.generated.h"
+
+/*
+ * Offline decoder of movement trace dumps.
+ * -run=HynmersTraceDecode -File=<dump.hmtrace> [-Csv=<output.csv>]
+ */
+UCLASS()
+class UHynmersTraceDecodeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UHynmersTraceDecodeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
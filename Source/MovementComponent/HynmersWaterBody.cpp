@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HynmersWaterBody.h"
+
+AHynmersWaterBody::AHynmersWaterBody(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	bWaterVolume = true;
+}
+
+bool AHynmersWaterBody::IsUnderSurface(const FVector& Location) const
+{
+	switch (Shape)
+	{
+	case EHynmersWaterShape::Plane:
+		return ((Location - GetActorLocation()) | GetActorUpVector()) <= 0.f;
+
+	case EHynmersWaterShape::SphereShell:
+		return FVector::DistSquared(Location, GetActorLocation()) <= FMath::Square(SurfaceRadius);
+
+	case EHynmersWaterShape::Box:
+	{
+		const FVector Local = GetActorQuat().UnrotateVector(Location - GetActorLocation());
+		return FMath::Abs(Local.X) <= BoxExtent.X && FMath::Abs(Local.Y) <= BoxExtent.Y && FMath::Abs(Local.Z) <= BoxExtent.Z;
+	}
+
+	default:
+		return false;
+	}
+}
+
+bool AHynmersWaterBody::TraceSurface(const FVector& Start, const FVector& End, float& OutTime) const
+{
+	switch (Shape)
+	{
+	case EHynmersWaterShape::Plane:
+	{
+		const FVector Normal = GetActorUpVector();
+		const float StartHeight = (Start - GetActorLocation()) | Normal;
+		const float EndHeight = (End - GetActorLocation()) | Normal;
+		if (StartHeight <= 0.f || EndHeight > 0.f)
+		{
+			return false;
+		}
+
+		OutTime = StartHeight / (StartHeight - EndHeight);
+		return true;
+	}
+
+	case EHynmersWaterShape::SphereShell:
+	{
+		const FVector Dir = End - Start;
+		const FVector Offset = Start - GetActorLocation();
+		const float A = Dir.SizeSquared();
+		const float B = Offset | Dir;
+		const float C = Offset.SizeSquared() - FMath::Square(SurfaceRadius);
+		if (C <= 0.f || A < SMALL_NUMBER)
+		{
+			return false;
+		}
+
+		// Near root of |Offset + Dir * t| = SurfaceRadius
+		const float Discriminant = B * B - A * C;
+		if (Discriminant < 0.f)
+		{
+			return false;
+		}
+
+		const float Time = (-B - FMath::Sqrt(Discriminant)) / A;
+		if (Time < 0.f || Time > 1.f)
+		{
+			return false;
+		}
+
+		OutTime = Time;
+		return true;
+	}
+
+	case EHynmersWaterShape::Box:
+	{
+		const FQuat Quat = GetActorQuat();
+		const FVector LocalStart = Quat.UnrotateVector(Start - GetActorLocation());
+		const FVector LocalDir = Quat.UnrotateVector(End - Start);
+
+		// Slabs, the segment enters the box at the last entry of the three axes
+		float EnterTime = 0.f;
+		float ExitTime = 1.f;
+		bool bStartInside = true;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const float Origin = LocalStart[Axis];
+			const float Extent = BoxExtent[Axis];
+			bStartInside &= FMath::Abs(Origin) <= Extent;
+
+			if (FMath::Abs(LocalDir[Axis]) < SMALL_NUMBER)
+			{
+				if (FMath::Abs(Origin) > Extent)
+				{
+					return false;
+				}
+				continue;
+			}
+
+			const float InvDir = 1.f / LocalDir[Axis];
+			float Near = (-Extent - Origin) * InvDir;
+			float Far = (Extent - Origin) * InvDir;
+			if (Near > Far)
+			{
+				Swap(Near, Far);
+			}
+			EnterTime = FMath::Max(EnterTime, Near);
+			ExitTime = FMath::Min(ExitTime, Far);
+			if (EnterTime > ExitTime)
+			{
+				return false;
+			}
+		}
+
+		if (bStartInside)
+		{
+			return false;
+		}
+
+		OutTime = EnterTime;
+		return true;
+	}
+
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PhysicsVolume.h"
+#include "HynmersWaterBody.generated.h"
+
+UENUM(BlueprintType)
+enum class EHynmersWaterShape : uint8
+{
+	// Water below the plane through the actor location, normal to the actor Z axis
+	Plane,
+	// Ocean around a planet, water inside the sphere of SurfaceRadius around the actor location
+	SphereShell,
+	// Water inside an oriented box around the actor location
+	Box,
+	// Traces against the brush, for shapes that have no closed form
+	Brush
+};
+
+/*
+ * Water volume whose surface is known in closed form, so immersion depth and the waterline are found
+ * without tracing the brush. The brush still decides which characters are inside the volume and should cover the shape.
+ */
+UCLASS()
+class MOVEMENTCOMPONENT_API AHynmersWaterBody : public APhysicsVolume
+{
+	GENERATED_BODY()
+
+public:
+	AHynmersWaterBody(const FObjectInitializer& ObjectInitializer);
+
+	bool HasAnalyticSurface() const { return Shape != EHynmersWaterShape::Brush; }
+
+	// Location below the surface. Only for analytic shapes.
+	bool IsUnderSurface(const FVector& Location) const;
+
+	// Time along the segment where it enters the water. False if it starts under the surface or never reaches it. Only for analytic shapes.
+	bool TraceSurface(const FVector& Start, const FVector& End, float& OutTime) const;
+
+	UPROPERTY(Category = "Water", EditAnywhere, BlueprintReadOnly)
+		EHynmersWaterShape Shape = EHynmersWaterShape::Plane;
+
+	// Radius of the surface of sphere shells
+	UPROPERTY(Category = "Water", EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", UIMin = "0"))
+		float SurfaceRadius = 5000.f;
+
+	// Local half extent of boxes
+	UPROPERTY(Category = "Water", EditAnywhere, BlueprintReadOnly)
+		FVector BoxExtent = FVector(1000.f);
+};
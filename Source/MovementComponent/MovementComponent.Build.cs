@@ -8,7 +8,9 @@ public class MovementComponent : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "OculusHMD" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "OculusHMD", "HynmersMovementCore" });
+
+        PrivateDependencyModuleNames.AddRange(new string[] { "PhysX", "APEX" });
 
         PublicIncludePathModuleNames.AddRange(new string[] { "OculusHMD" });
 
@@ -1,7 +1,28 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
 #include "MovementComponent.h"
+#include "HynmersMovementTrace.h"
+#include "Misc/CoreDelegates.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, MovementComponent, "MovementComponent" );
- 
\ No newline at end of file
+class FMovementComponentModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		EnsureHandle = FCoreDelegates::OnHandleSystemEnsure.AddStatic(&FHynmersMovementTrace::OnSystemEnsure);
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FHynmersMovementTrace::FlushPendingDump);
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FCoreDelegates::OnHandleSystemEnsure.Remove(EnsureHandle);
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	}
+
+private:
+	FDelegateHandle EnsureHandle;
+	FDelegateHandle EndFrameHandle;
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FMovementComponentModule, MovementComponent, "MovementComponent" );